@@ -0,0 +1,56 @@
+//
+// Created by visan on 5/23/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/benchmark/catch_benchmark.hpp>
+#include<cmath>
+#include<vector>
+#include "../src/defines.h"
+#include "../src/sampling.h"
+#include "../src/niching.h"
+
+using namespace GeneticSimulation;
+
+// The size of the populations.
+static constexpr size_t population_size = 10000;
+
+// The niche radius.
+static constexpr double radius = 0.01;
+
+TEST_CASE("Niche counts", "[!benchmark][niching]") {
+    std::vector<double> points(population_size), fitness(population_size), shared;
+    fill_uniform(rng, points.data(), points.size());
+    fill_uniform(rng, fitness.data(), fitness.size());
+    std::vector<size_t> order, position, winners;
+    std::vector<double> prefix;
+    std::vector<char> cleared;
+
+    BENCHMARK("Naive sharing") {
+        shared = fitness;
+        for (size_t i = 0; i < points.size(); i++) {
+            double count = 0;
+            for (double y: points) {
+                double d = std::abs(points[i] - y);
+                if (d < radius) {
+                    count += 1 - d / radius;
+                }
+            }
+            shared[i] /= count;
+        }
+        return shared[0];
+    };
+    BENCHMARK("Sorted sharing, alpha = 1") {
+        shared = fitness;
+        share_fitness(points, shared, radius, 1, order, prefix);
+        return shared[0];
+    };
+    BENCHMARK("Sorted sharing, alpha = 2") {
+        shared = fitness;
+        share_fitness(points, shared, radius, 2, order, prefix);
+        return shared[0];
+    };
+    BENCHMARK("Clearing") {
+        niche_winners(points, fitness, radius, winners, order, position, cleared);
+        return winners.size();
+    };
+}
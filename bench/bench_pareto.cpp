@@ -0,0 +1,50 @@
+//
+// Created by visan on 5/24/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/benchmark/catch_benchmark.hpp>
+#include<vector>
+#include "../src/defines.h"
+#include "../src/sampling.h"
+#include "../src/pareto.h"
+
+using namespace GeneticSimulation;
+
+/*
+ * Returns the given number of points with random objectives in [0, 1).
+ */
+static std::vector<objective_vector> random_points(size_t count) {
+    std::vector<objective_vector> points(count);
+    for (objective_vector &point: points) {
+        point = {uniform(rng), uniform(rng), uniform(rng)};
+    }
+    return points;
+}
+
+TEST_CASE("Non-dominated sort", "[!benchmark][pareto]") {
+    rng.seed(5);
+    std::vector<objective_vector> small = random_points(10000);
+    std::vector<objective_vector> medium = random_points(30000);
+    std::vector<objective_vector> large = random_points(100000);
+    std::vector<std::vector<size_t>> fronts;
+    std::vector<unsigned int> rank;
+    std::vector<size_t> order;
+    std::vector<staircase> staircases;
+
+    BENCHMARK("2 objectives, 100000 points") {
+        non_dominated_sort(large, 2, fronts, rank, order, staircases);
+        return fronts.size();
+    };
+    BENCHMARK("3 objectives, 10000 points") {
+        non_dominated_sort(small, 3, fronts, rank, order, staircases);
+        return fronts.size();
+    };
+    BENCHMARK("3 objectives, 30000 points") {
+        non_dominated_sort(medium, 3, fronts, rank, order, staircases);
+        return fronts.size();
+    };
+    BENCHMARK("3 objectives, 100000 points") {
+        non_dominated_sort(large, 3, fronts, rank, order, staircases);
+        return fronts.size();
+    };
+}
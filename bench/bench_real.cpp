@@ -0,0 +1,83 @@
+//
+// Created by visan on 5/27/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/benchmark/catch_benchmark.hpp>
+#include<algorithm>
+#include<cmath>
+#include<iomanip>
+#include<iostream>
+#include<string>
+#include "../src/engine.h"
+#include "../src/real_engine.h"
+
+using namespace GeneticSimulation;
+
+// g from main.cpp, on [-2, 4].
+static double g(double x) {
+    double c = cos(x * x + x + 7);
+    double s = sin(x + 10);
+    return c * c - s + 5;
+}
+
+// The maximum of g on [-2, 4], at x = 1.12921.
+static constexpr double g_maximum = 6.990665772751;
+
+// The number of seeded runs averaged for every budget.
+static constexpr unsigned int runs = 50;
+
+// The population of every run.
+static constexpr unsigned int population_size = 20;
+
+/*
+ * Returns the mean distance to the maximum of g reached by the given engine, over seeded runs of the given number
+ * of epochs.
+ */
+template<typename E>
+static double mean_error(E &engine, unsigned int epochs) {
+    double error = 0;
+    for (unsigned int seed = 1; seed <= runs; seed++) {
+        rng.seed(seed);
+        error += std::max(0.0, g_maximum - g(engine.run(epochs)));
+    }
+    return error / runs;
+}
+
+TEST_CASE("Accuracy per evaluation", "[!benchmark][real]") {
+    // A precision of 6 decimals on [-2, 4] needs 23 bits.
+    Engine<uint32_t, 23> bitstring(g, population_size, {-2, 4}, 0.25, 0.01);
+    Engine<uint32_t, 23, TournamentSelection, UniformCrossover> tuned_bitstring(g, population_size, {-2, 4}, 0.6,
+                                                                                 0.2);
+    RealEngine<> sbx(g, population_size, {-2, 4}, 0.6, 0.2);
+    RealEngine<RouletteSelection, BlendCrossover, GaussianMutation> blx(g, population_size, {-2, 4}, 0.6, 0.2,
+                                                                        BlendCrossover{0.5},
+                                                                        GaussianMutation{0.01});
+
+    std::cout << "Mean distance to the maximum of g, over " << runs << " runs" << std::endl;
+    std::cout << std::setw(12) << "evaluations" << std::setw(16) << "bitstring" << std::setw(16) << "bitstring*"
+              << std::setw(16) << "SBX + PM" << std::setw(16) << "BLX + Gaussian" << std::endl;
+    for (unsigned int evaluations: {200u, 1000u, 5000u, 20000u}) {
+        unsigned int epochs = evaluations / population_size;
+        std::cout << std::setw(12) << evaluations << std::scientific << std::setprecision(2)
+                  << std::setw(16) << mean_error(bitstring, epochs) << std::setw(16)
+                  << mean_error(tuned_bitstring, epochs) << std::setw(16) << mean_error(sbx, epochs)
+                  << std::setw(16) << mean_error(blx, epochs) << std::defaultfloat << std::endl;
+    }
+}
+
+TEST_CASE("Real-coded epoch", "[!benchmark][real]") {
+    const unsigned int size = 100000;
+    Engine<uint32_t, 23> bitstring(g, size, {-2, 4}, 0.25, 0.01);
+    RealEngine<> real(g, size, {-2, 4}, 0.25, 0.01);
+    bitstring.initialise();
+    real.initialise();
+
+    BENCHMARK("Bitstring, epoch") {
+        bitstring.step();
+        return bitstring.get_population()[0];
+    };
+    BENCHMARK("Real-coded, epoch") {
+        real.step();
+        return real.get_population()[0];
+    };
+}
@@ -0,0 +1,64 @@
+//
+// Created by visan on 5/22/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/benchmark/catch_benchmark.hpp>
+#include<algorithm>
+#include<string>
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+// The size of the populations.
+static constexpr unsigned int population_size = 100000;
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+TEST_CASE("Replacement strategies", "[!benchmark][replacement]") {
+    std::vector<std::pair<std::string, Replacement>> strategies = {
+            {"Generational, 1 elite",       Replacement::generational()},
+            {"Generational, 1000 elites",   Replacement::generational(1000)},
+            {"Plus, lambda = mu",           Replacement::plus(population_size)},
+            {"Comma, lambda = 2 mu",        Replacement::comma(2 * population_size)},
+            {"Age, lambda = mu / 10",       Replacement::age(population_size / 10)},
+    };
+    for (const auto &[name, replacement]: strategies) {
+        Optimiser opt(parabola, population_size, {-1, 2}, 6, 0.25, 0.01, 1);
+        opt.set_replacement(replacement);
+        std::vector<Organism> population = opt.initial_population();
+        opt.evolve(population);
+
+        BENCHMARK(name + ", epoch") {
+            opt.evolve(population);
+            return population[0].get_chromosome();
+        };
+    }
+}
+
+TEST_CASE("Top k selection", "[!benchmark][replacement]") {
+    std::vector<double> scores(population_size);
+    fill_uniform(rng, scores.data(), scores.size());
+    std::vector<size_t> indices(population_size);
+    auto better = [&scores](size_t a, size_t b) {
+        return scores[a] > scores[b];
+    };
+
+    for (size_t k: {1ul, 1000ul, 50000ul}) {
+        BENCHMARK("Full sort, k = " + std::to_string(k)) {
+            for (size_t i = 0; i < indices.size(); i++) {
+                indices[i] = i;
+            }
+            std::sort(indices.begin(), indices.end(), better);
+            return indices[k - 1];
+        };
+        BENCHMARK("top_k, k = " + std::to_string(k)) {
+            for (size_t i = 0; i < indices.size(); i++) {
+                indices[i] = i;
+            }
+            top_k(indices, k, better);
+            return indices[k - 1];
+        };
+    }
+}
@@ -0,0 +1,58 @@
+//
+// Created by visan on 5/21/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/benchmark/catch_benchmark.hpp>
+#include<vector>
+#include "../src/sampling.h"
+
+using namespace GeneticSimulation;
+
+// The number of values drawn by every benchmark.
+static constexpr size_t count = 100000;
+
+TEST_CASE("Uniform doubles", "[!benchmark][sampling]") {
+    std::mt19937 generator(1);
+    std::vector<double> values(count);
+
+    BENCHMARK("std::uniform_real_distribution, one per value") {
+        for (double &value: values) {
+            std::uniform_real_distribution<> dist(0, 1);
+            value = dist(generator);
+        }
+        return values[0];
+    };
+    BENCHMARK("uniform") {
+        for (double &value: values) {
+            value = uniform(generator);
+        }
+        return values[0];
+    };
+    BENCHMARK("fill_uniform") {
+        fill_uniform(generator, values.data(), values.size());
+        return values[0];
+    };
+}
+
+TEST_CASE("Bounded integers", "[!benchmark][sampling]") {
+    std::mt19937 generator(1);
+    std::vector<uint32_t> values(count);
+
+    BENCHMARK("std::uniform_int_distribution, one per value") {
+        for (uint32_t &value: values) {
+            std::uniform_int_distribution<std::mt19937::result_type> dist(0, 21);
+            value = dist(generator);
+        }
+        return values[0];
+    };
+    BENCHMARK("bounded") {
+        for (uint32_t &value: values) {
+            value = bounded(generator, 22);
+        }
+        return values[0];
+    };
+    BENCHMARK("fill_bounded") {
+        fill_bounded(generator, 22, values.data(), values.size());
+        return values[0];
+    };
+}
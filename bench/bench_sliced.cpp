@@ -0,0 +1,116 @@
+//
+// Created by visan on 5/20/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/benchmark/catch_benchmark.hpp>
+#include<string>
+#include "../src/organism.h"
+#include "../src/sliced.h"
+
+using namespace GeneticSimulation;
+
+// The size of the populations.
+static constexpr size_t population_size = 1000000;
+
+// The probability of a gene to be flipped.
+static constexpr double gene_mutation = 0.001;
+
+static std::vector<Organism> random_organisms(unsigned int bits) {
+    std::vector<Organism> organisms;
+    for (size_t i = 0; i < population_size; i++) {
+        organisms.push_back(Organism::random_organism(bits));
+    }
+    return organisms;
+}
+
+TEST_CASE("Bit-sliced mutation", "[!benchmark][sliced]") {
+    for (unsigned int bits: {8u, 16u, 24u}) {
+        std::vector<Organism> organisms = random_organisms(bits);
+        SlicedPopulation sliced = SlicedPopulation::random_population(bits, population_size);
+
+        BENCHMARK("Organisms, " + std::to_string(bits) + " bits") {
+            // The same gap sampling as the sliced population, one organism at a time.
+            std::geometric_distribution<size_t> gap(gene_mutation);
+            size_t genes = organisms.size() * bits;
+            for (size_t position = gap(rng); position < genes; position += gap(rng) + 1) {
+                organisms[position / bits].mutate(position % bits);
+            }
+            return organisms[0].get_chromosome();
+        };
+        BENCHMARK("Sliced, " + std::to_string(bits) + " bits") {
+            sliced.mutate(gene_mutation);
+            return sliced.get(0);
+        };
+    }
+}
+
+TEST_CASE("Bit-sliced uniform cross-over", "[!benchmark][sliced]") {
+    for (unsigned int bits: {8u, 16u, 24u}) {
+        std::vector<Organism> organisms = random_organisms(bits);
+        SlicedPopulation sliced = SlicedPopulation::random_population(bits, population_size);
+
+        BENCHMARK("Organisms, " + std::to_string(bits) + " bits") {
+            std::bernoulli_distribution crossed(0.5);
+            for (size_t i = 0; i + 1 < organisms.size(); i += 2) {
+                if (crossed(rng)) {
+                    bitvector a = organisms[i].get_chromosome();
+                    bitvector b = organisms[i + 1].get_chromosome();
+                    bitvector swapped = (a ^ b) & random_bitvector(bits);
+                    organisms[i].set_chromosome(a ^ swapped);
+                    organisms[i + 1].set_chromosome(b ^ swapped);
+                }
+            }
+            return organisms[0].get_chromosome();
+        };
+        BENCHMARK("Sliced, " + std::to_string(bits) + " bits") {
+            sliced.uniform_crossover(0.5);
+            return sliced.get(0);
+        };
+    }
+}
+
+TEST_CASE("Bit-sliced frequencies", "[!benchmark][sliced]") {
+    for (unsigned int bits: {8u, 16u, 24u}) {
+        std::vector<Organism> organisms = random_organisms(bits);
+        SlicedPopulation sliced = SlicedPopulation::random_population(bits, population_size);
+        std::vector<size_t> counts;
+
+        BENCHMARK("Organisms, " + std::to_string(bits) + " bits") {
+            counts.assign(bits, 0);
+            for (const Organism &o: organisms) {
+                for (unsigned int gene = 0; gene < bits; gene++) {
+                    counts[gene] += (o.get_chromosome() >> gene) & 1;
+                }
+            }
+            return counts[0];
+        };
+        BENCHMARK("Sliced, " + std::to_string(bits) + " bits") {
+            sliced.bit_frequencies(counts);
+            return counts[0];
+        };
+    }
+}
+
+TEST_CASE("Bit-sliced decoding", "[!benchmark][sliced]") {
+    for (unsigned int bits: {8u, 16u, 24u}) {
+        SlicedPopulation sliced = SlicedPopulation::random_population(bits, population_size);
+
+        BENCHMARK("One organism at a time, " + std::to_string(bits) + " bits") {
+            bitvector sum = 0;
+            for (size_t i = 0; i < population_size; i++) {
+                sum += sliced.get(i);
+            }
+            return sum;
+        };
+        BENCHMARK("Transpose, " + std::to_string(bits) + " bits") {
+            bitvector sum = 0, chromosomes[64];
+            for (size_t block = 0; block < population_size / 64; block++) {
+                sliced.decode(block, chromosomes);
+                for (bitvector chromosome: chromosomes) {
+                    sum += chromosome;
+                }
+            }
+            return sum;
+        };
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Created by visan on 5/14/23.
+//
+
+#include "adaptive.h"
+#include<algorithm>
+#include<cmath>
+
+namespace GeneticSimulation {
+    void RateController::reset() {
+
+    }
+
+    OneFifthRule::OneFifthRule(unsigned int _window, double _factor, double _min_probability,
+                               double _max_probability) :
+            window(_window),
+            factor(_factor),
+            min_probability(_min_probability),
+            max_probability(_max_probability),
+            best(0),
+            epochs(0),
+            successes(0) {
+
+    }
+
+    void OneFifthRule::update(const epoch_stats &stats, double &, double &mutation_probability) {
+        if (stats.max_fitness > best) {
+            best = stats.max_fitness;
+            successes++;
+        }
+        epochs++;
+
+        if (epochs < window) {
+            return;
+        }
+
+        // The window has ended, so adjust the mutation probability.
+        if (successes * 5 > epochs) {
+            mutation_probability *= factor;
+        } else {
+            mutation_probability /= factor;
+        }
+        mutation_probability = std::clamp(mutation_probability, min_probability, max_probability);
+        epochs = 0;
+        successes = 0;
+    }
+
+    void OneFifthRule::reset() {
+        best = 0;
+        epochs = 0;
+        successes = 0;
+    }
+
+    DiversityControl::DiversityControl(double _target, double _gain, double _min_probability,
+                                       double _max_probability) :
+            target(_target),
+            gain(_gain),
+            min_probability(_min_probability),
+            max_probability(_max_probability) {
+
+    }
+
+    void DiversityControl::update(const epoch_stats &stats, double &cross_probability, double &mutation_probability) {
+        // The relative error is positive when the population is not diverse enough.
+        double error = (target - stats.diversity) / target;
+        double scale = std::exp(gain * error);
+
+        mutation_probability = std::clamp(mutation_probability * scale, min_probability, max_probability);
+        cross_probability = std::clamp(cross_probability / scale, min_probability, max_probability);
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Created by visan on 5/14/23.
+//
+
+#ifndef GENETICSIMULATION_ADAPTIVE_H
+#define GENETICSIMULATION_ADAPTIVE_H
+
+namespace GeneticSimulation {
+    /*
+     * Cheap statistics about a population, gathered once per epoch.
+     */
+    struct epoch_stats {
+        // The index of the epoch.
+        unsigned int epoch;
+
+        // The number of fitness evaluations performed since the start of the run.
+        unsigned long long evaluations;
+
+        // The maximum and the average fitness of the population.
+        double max_fitness;
+        double average_fitness;
+
+        // The bit diversity of the population, in [0,1]. It is 0 when all organisms are identical.
+        double diversity;
+
+        // The operator rates used to generate the next population.
+        double cross_probability;
+        double mutation_probability;
+    };
+
+    /*
+     * This class adjusts the cross-over and the mutation probabilities of the optimiser
+     * between epochs, based on the statistics of the current population.
+     */
+    class RateController {
+    public:
+        virtual ~RateController() = default;
+
+        /*
+         * Called once per epoch, before the next generation is created. The controller may change
+         * the given probabilities, which are then used by the cross-over and mutation stages.
+         */
+        virtual void update(const epoch_stats &stats, double &cross_probability, double &mutation_probability) = 0;
+
+        /*
+         * Called at the start of every run, to forget the state of the last run. It does nothing by default.
+         */
+        virtual void reset();
+    };
+
+    /*
+     * Rechenberg's 1/5th success rule applied to the mutation probability. An epoch is successful if
+     * it improves the best fitness seen so far. Every window epochs, if more than a fifth of them were
+     * successful, the mutation probability is multiplied by the given factor, otherwise it is divided by it.
+     */
+    class OneFifthRule : public RateController {
+    private:
+        unsigned int window;
+        double factor;
+        double min_probability;
+        double max_probability;
+
+        // The best fitness seen so far.
+        double best;
+
+        // The number of epochs and successful epochs in the current window.
+        unsigned int epochs;
+        unsigned int successes;
+
+    public:
+        explicit OneFifthRule(unsigned int _window = 10, double _factor = 1.5,
+                              double _min_probability = 0.001, double _max_probability = 0.5);
+
+        void update(const epoch_stats &stats, double &cross_probability, double &mutation_probability) override;
+
+        void reset() override;
+    };
+
+    /*
+     * Keeps the bit diversity of the population around a target value. When the population is less
+     * diverse than the target, the mutation probability is raised and the cross-over probability is lowered
+     * (crossing similar organisms is wasted work), and the other way around.
+     */
+    class DiversityControl : public RateController {
+    private:
+        double target;
+        double gain;
+        double min_probability;
+        double max_probability;
+
+    public:
+        explicit DiversityControl(double _target = 0.2, double _gain = 0.1,
+                                  double _min_probability = 0.001, double _max_probability = 0.9);
+
+        void update(const epoch_stats &stats, double &cross_probability, double &mutation_probability) override;
+    };
+}
+
+#endif //GENETICSIMULATION_ADAPTIVE_H
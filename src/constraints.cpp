@@ -0,0 +1,51 @@
+//
+// Created by visan on 5/17/23.
+//
+
+#include "constraints.h"
+#include<algorithm>
+
+namespace GeneticSimulation {
+    void Constraints::add_predicate(std::function<bool(double)> predicate) {
+        predicates.push_back(std::move(predicate));
+    }
+
+    void Constraints::add_penalty(std::function<double(double)> violation, double weight) {
+        penalties.push_back(std::move(violation));
+        weights.push_back(weight);
+    }
+
+    void Constraints::set_repair(std::function<double(double)> repair) {
+        repair_function = std::move(repair);
+    }
+
+    bool Constraints::empty() const {
+        return predicates.empty() && penalties.empty();
+    }
+
+    unsigned int Constraints::failed_predicates(double x) const {
+        unsigned int failed = 0;
+        for (const std::function<bool(double)> &predicate: predicates) {
+            if (!predicate(x)) {
+                failed++;
+            }
+        }
+        return failed;
+    }
+
+    double Constraints::penalty(double x) const {
+        double total = 0;
+        for (size_t i = 0; i < penalties.size(); i++) {
+            total += weights[i] * std::max(0.0, penalties[i](x));
+        }
+        return total;
+    }
+
+    bool Constraints::can_repair() const {
+        return (bool) repair_function;
+    }
+
+    double Constraints::repair(double x) const {
+        return repair_function(x);
+    }
+}
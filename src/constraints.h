@@ -0,0 +1,73 @@
+//
+// Created by visan on 5/17/23.
+//
+
+#ifndef GENETICSIMULATION_CONSTRAINTS_H
+#define GENETICSIMULATION_CONSTRAINTS_H
+
+#include<functional>
+#include<vector>
+
+namespace GeneticSimulation {
+    /*
+     * This class describes the constraints of an optimisation problem, on top of the domain.
+     * There are two kinds of constraints:
+     * - predicates: cheap checks of feasibility, which are evaluated before the function. If one of them fails,
+     * the point is infeasible and the function is not evaluated at all.
+     * - penalties: functions that return by how much a point violates a soft constraint (0 if it does not).
+     * The weighted violations are subtracted from the fitness of the point.
+     * A repair function may also be given. It maps an infeasible point to a feasible one, so that
+     * infeasible offspring can be fixed instead of rejected.
+     */
+    class Constraints {
+    private:
+        std::vector<std::function<bool(double)>> predicates;
+        std::vector<std::function<double(double)>> penalties;
+        std::vector<double> weights;
+        std::function<double(double)> repair_function;
+
+    public:
+        /*
+         * Adds a cheap feasibility check.
+         */
+        void add_predicate(std::function<bool(double)> predicate);
+
+        /*
+         * Adds a soft constraint. The violation function must return 0 when the constraint is satisfied
+         * and a positive amount otherwise.
+         */
+        void add_penalty(std::function<double(double)> violation, double weight);
+
+        /*
+         * Sets the function used to repair infeasible points.
+         */
+        void set_repair(std::function<double(double)> repair);
+
+        /*
+         * Returns true if there are no constraints.
+         */
+        bool empty() const;
+
+        /*
+         * Returns the number of predicates that the given point fails. The point is feasible if it is 0.
+         */
+        unsigned int failed_predicates(double x) const;
+
+        /*
+         * Returns the weighted sum of the violations of the soft constraints.
+         */
+        double penalty(double x) const;
+
+        /*
+         * Returns true if a repair function was given.
+         */
+        bool can_repair() const;
+
+        /*
+         * Maps the given point to a feasible one, using the repair function.
+         */
+        double repair(double x) const;
+    };
+}
+
+#endif //GENETICSIMULATION_CONSTRAINTS_H
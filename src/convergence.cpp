@@ -0,0 +1,134 @@
+//
+// Created by visan on 5/26/23.
+//
+
+#include "convergence.h"
+#include<cmath>
+#include<iomanip>
+#include<limits>
+#include<sstream>
+#include<stdexcept>
+
+namespace GeneticSimulation {
+    // The quantile of the standard normal distribution for a 95% confidence level.
+    static constexpr double z95 = 1.959963984540054;
+
+    estimate mean_estimate(const std::vector<double> &values) {
+        if (values.empty()) {
+            return {0, 0, 0};
+        }
+        auto n = (double) values.size();
+        double mean = 0;
+        for (double x: values) {
+            mean += x;
+        }
+        mean /= n;
+        if (values.size() == 1) {
+            return {mean, mean, mean};
+        }
+
+        double variance = 0;
+        for (double x: values) {
+            variance += (x - mean) * (x - mean);
+        }
+        variance /= n - 1;
+        double margin = z95 * std::sqrt(variance / n);
+        return {mean, mean - margin, mean + margin};
+    }
+
+    estimate proportion_estimate(size_t successes, size_t trials) {
+        if (trials == 0) {
+            return {0, 0, 1};
+        }
+        auto n = (double) trials;
+        double p = (double) successes / n;
+        double z2 = z95 * z95;
+        double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+        double margin = z95 / (1 + z2 / n) * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n));
+        return {p, std::max(0.0, center - margin), std::min(1.0, center + margin)};
+    }
+
+    convergence_stats measure_convergence(const job &configuration, unsigned int runs, unsigned int threads) {
+        std::vector<job> jobs;
+        for (unsigned int r = 0; r < runs; r++) {
+            job j = configuration;
+            j.index = r;
+            j.seed = configuration.seed + r;
+            jobs.push_back(j);
+        }
+        std::vector<job_result> results = run_jobs(jobs, threads);
+
+        size_t successes = 0;
+        std::vector<double> evaluations, seconds;
+        for (const job_result &result: results) {
+            seconds.push_back(result.seconds);
+            if (result.fitness >= configuration.target_fitness) {
+                successes++;
+                evaluations.push_back((double) result.evaluations);
+            }
+        }
+        return {configuration.objective, results.size(), proportion_estimate(successes, results.size()),
+                mean_estimate(evaluations), mean_estimate(seconds)};
+    }
+
+    static void write_estimate(std::ostream &os, const estimate &e) {
+        os << ' ' << e.mean << ' ' << e.low << ' ' << e.high;
+    }
+
+    void save_baseline(std::ostream &os, const std::vector<convergence_stats> &stats) {
+        os << std::setprecision(std::numeric_limits<double>::max_digits10);
+        os << "# objective runs success_rate low high evaluations low high seconds low high\n";
+        for (const convergence_stats &s: stats) {
+            os << s.objective << ' ' << s.runs;
+            write_estimate(os, s.success_rate);
+            write_estimate(os, s.evaluations);
+            write_estimate(os, s.seconds);
+            os << '\n';
+        }
+    }
+
+    std::vector<convergence_stats> load_baseline(std::istream &is) {
+        std::vector<convergence_stats> stats;
+        std::string line;
+        while (std::getline(is, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            convergence_stats s{};
+            if (!(fields >> s.objective >> s.runs >> s.success_rate.mean >> s.success_rate.low >> s.success_rate.high
+                         >> s.evaluations.mean >> s.evaluations.low >> s.evaluations.high >> s.seconds.mean
+                         >> s.seconds.low >> s.seconds.high)) {
+                throw std::runtime_error("Malformed baseline: " + line);
+            }
+            stats.push_back(s);
+        }
+        return stats;
+    }
+
+    std::vector<std::string> find_regressions(const convergence_stats &current, const convergence_stats &baseline,
+                                              double tolerance, double time_tolerance) {
+        std::vector<std::string> regressions;
+        std::ostringstream message;
+        if (current.success_rate.high < baseline.success_rate.mean - tolerance) {
+            message << current.objective << ": the success rate dropped from " << baseline.success_rate.mean
+                    << " to " << current.success_rate.mean << " [" << current.success_rate.low << ", "
+                    << current.success_rate.high << "]";
+            regressions.push_back(message.str());
+            message.str("");
+        }
+        if (current.evaluations.low > baseline.evaluations.mean * (1 + tolerance)) {
+            message << current.objective << ": the evaluations to the target rose from " << baseline.evaluations.mean
+                    << " to " << current.evaluations.mean << " [" << current.evaluations.low << ", "
+                    << current.evaluations.high << "]";
+            regressions.push_back(message.str());
+            message.str("");
+        }
+        if (current.seconds.low > baseline.seconds.mean * (1 + time_tolerance)) {
+            message << current.objective << ": the time of a run rose from " << baseline.seconds.mean << " s to "
+                    << current.seconds.mean << " s [" << current.seconds.low << ", " << current.seconds.high << "]";
+            regressions.push_back(message.str());
+        }
+        return regressions;
+    }
+}
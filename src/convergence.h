@@ -0,0 +1,80 @@
+//
+// Created by visan on 5/26/23.
+//
+
+#ifndef GENETICSIMULATION_CONVERGENCE_H
+#define GENETICSIMULATION_CONVERGENCE_H
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include "experiment.h"
+
+namespace GeneticSimulation {
+    /*
+     * A value estimated from a sample, with its 95% confidence interval.
+     */
+    struct estimate {
+        double mean;
+        double low;
+        double high;
+    };
+
+    /*
+     * How well the optimiser converges on an objective, measured over many seeded runs that stop when they reach
+     * a target fitness.
+     */
+    struct convergence_stats {
+        std::string objective;
+        size_t runs;
+
+        // The fraction of runs that reached the target, with the Wilson score interval.
+        estimate success_rate;
+
+        // The number of evaluations needed to reach the target, over the successful runs, with the normal
+        // approximation. It is 0 if no run succeeded.
+        estimate evaluations;
+
+        // The wall-clock time of a run, in seconds, over all the runs.
+        estimate seconds;
+    };
+
+    /*
+     * Returns the mean of the given values, with the normal approximation of its 95% confidence interval.
+     */
+    estimate mean_estimate(const std::vector<double> &values);
+
+    /*
+     * Returns the fraction of successes, with its 95% Wilson score interval.
+     */
+    estimate proportion_estimate(size_t successes, size_t trials);
+
+    /*
+     * Runs the given job once per seed, seed, seed + 1 ... seed + runs - 1, on the given number of threads,
+     * and gathers the convergence statistics. The job must have a finite target fitness.
+     */
+    convergence_stats measure_convergence(const job &configuration, unsigned int runs, unsigned int threads = 0);
+
+    /*
+     * Writes the given statistics to the given stream, one objective per line:
+     * objective runs success_rate evaluations seconds, with their confidence intervals.
+     */
+    void save_baseline(std::ostream &os, const std::vector<convergence_stats> &stats);
+
+    /*
+     * Reads statistics written by save_baseline. Throws std::runtime_error if the stream is malformed.
+     */
+    std::vector<convergence_stats> load_baseline(std::istream &is);
+
+    /*
+     * Compares the given statistics to the baseline of the same objective, and returns a description of every
+     * regression. A metric regresses only if its whole confidence interval is worse than the baseline by more than
+     * the tolerance: the success rate by more than tolerance (an absolute difference), the evaluations by
+     * more than a factor of 1 + tolerance and the time by more than a factor of 1 + time_tolerance.
+     * The time depends on the machine, so it usually gets a looser tolerance.
+     */
+    std::vector<std::string> find_regressions(const convergence_stats &current, const convergence_stats &baseline,
+                                              double tolerance, double time_tolerance);
+}
+
+#endif //GENETICSIMULATION_CONVERGENCE_H
@@ -2,9 +2,11 @@
 // Created by visan on 5/12/23.
 //
 #include"defines.h"
+#include"sampling.h"
+#include<cmath>
 
 namespace GeneticSimulation {
-    std::mt19937 rng;
+    thread_local std::mt19937 rng;
 
     unsigned int fast_pow(unsigned int base, unsigned int power) {
         unsigned int result = 1;
@@ -25,16 +27,31 @@ namespace GeneticSimulation {
         return num_bits;
     }
 
-    unsigned int random_bitvector(unsigned int num_bits) {
-        unsigned int maximum = (1 << num_bits) - 1;
-        std::uniform_int_distribution<std::mt19937::result_type> distribution(0, maximum);
-        return distribution(rng);
+    unsigned int chromosome_bits(range domain, unsigned int precision) {
+        // The number of discrete points in the domain.
+        // The formula is : (b-a) * 10^p
+        auto num_discrete = (unsigned int) std::ceil((domain.right - domain.left) * fast_pow(10, precision));
+        return ceil_log(num_discrete);
+    }
+
+    bitvector random_bitvector(unsigned int num_bits) {
+        bitvector result = 0;
+        unsigned int filled = 0;
+        // Whole words come straight from the generator, which produces 32 random bits at a time.
+        while (num_bits - filled >= 32) {
+            result |= (bitvector) rng() << filled;
+            filled += 32;
+        }
+        if (filled < num_bits) {
+            result |= (bitvector) bounded(rng, 1u << (num_bits - filled)) << filled;
+        }
+        return result;
     }
 
     std::string bitvector_to_string(bitvector vector, unsigned int num_bits) {
         std::string result;
         for (long long x = num_bits - 1; x >= 0; x--) {
-            if ((vector & (1 << x)) != 0) {
+            if ((vector & ((bitvector) 1 << x)) != 0) {
                 result.push_back('1');
             } else {
                 result.push_back('0');
@@ -5,7 +5,9 @@
 #ifndef GENETICSIMULATION_INCLUDES_H
 #define GENETICSIMULATION_INCLUDES_H
 
+#include<cmath>
 #include<cstdint>
+#include<limits>
 #include<random>
 #include<string>
 
@@ -27,11 +29,54 @@ namespace GeneticSimulation {
      */
     unsigned int ceil_log(unsigned int x);
 
-    // The random number generator;
-    extern std::mt19937 rng;
+    /*
+     * The binary encoding shared by the optimisers: the domain is divided into (b-a) * 10^precision discrete points,
+     * and a chromosome is the index of a point, on enough bits to represent all of them.
+     * Returns the number of bits of a chromosome for the given domain and precision.
+     */
+    unsigned int chromosome_bits(range domain, unsigned int precision);
+
+    // Returns the size of a discrete interval, when the domain is divided in 2^bits intervals.
+    inline double discrete_step(range domain, unsigned int bits) {
+        return std::ldexp(domain.right - domain.left, -(int) bits);
+    }
+
+    // Converts the given chromosome to a number in the domain, given the size of a discrete interval.
+    // It is inline, because the engines decode every organism of every epoch.
+    inline double decode_chromosome(bitvector chromosome, range domain, double step_size) {
+        return (double) chromosome * step_size + domain.left;
+    }
 
-    // Generates a random array of bits of the given size.
-    unsigned int random_bitvector(unsigned int num_bits);
+    // The random number generator. Every thread has its own, so that optimisers can run in parallel.
+    extern thread_local std::mt19937 rng;
+
+    /*
+     * Generates a random array of bits of the given size, at most 64. The bits are drawn from rng 32 at a time,
+     * starting with the lowest ones.
+     */
+    bitvector random_bitvector(unsigned int num_bits);
+
+    /*
+     * The single point cross-over of two chromosomes stored in unsigned words: the genes after gene i, that is
+     * i+1, i+2 ... are swapped between the two chromosomes.
+     */
+    template<typename Word>
+    void cross_chromosomes(Word &a, Word &b, unsigned int i) {
+        // Mask bits 0,1 ... i.
+        Word mask = i + 1 >= (unsigned int) std::numeric_limits<Word>::digits ? (Word) ~(Word) 0 :
+                    (Word) (((Word) 1 << (i + 1)) - 1);
+        Word swapped = (a ^ b) & (Word) ~mask;
+        a ^= swapped;
+        b ^= swapped;
+    }
+
+    /*
+     * Flips gene i of a chromosome stored in an unsigned word.
+     */
+    template<typename Word>
+    void flip_gene(Word &chromosome, unsigned int i) {
+        chromosome ^= (Word) ((Word) 1 << i);
+    }
 
     // Converts the given bitvector to a string of ones and zeroes.
     std::string bitvector_to_string(bitvector vector, unsigned int num_bits);
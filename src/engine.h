@@ -0,0 +1,343 @@
+//
+// Created by visan on 5/19/23.
+//
+
+#ifndef GENETICSIMULATION_ENGINE_H
+#define GENETICSIMULATION_ENGINE_H
+
+#include<algorithm>
+#include<cmath>
+#include<iostream>
+#include<limits>
+#include<memory>
+#include<type_traits>
+#include<vector>
+#include "defines.h"
+#include "trace.h"
+#include "sampling.h"
+
+namespace GeneticSimulation {
+    /*
+     * The policies of the engines write their trace to the stream they are given, and only if their Trace
+     * parameter enables it.
+     */
+
+    /*
+     * Prints a population of chromosomes of the given width to the given stream.
+     */
+    template<typename Word, unsigned int Width>
+    void show_chromosomes(const std::vector<Word> &population, std::ostream &out) {
+        for (size_t i = 0; i < population.size(); i++) {
+            out << i + 1 << ": " << bitvector_to_string(population[i], Width) << std::endl;
+        }
+        out << std::endl;
+    }
+
+    /*
+     * Selection policy: roulette wheel selection, where the probability of an organism to be selected is
+     * proportional to its fitness.
+     */
+    struct RouletteSelection {
+        template<typename Word, unsigned int Width, typename Trace>
+        static void select(const std::vector<Word> &population, const std::vector<double> &fitness, size_t count,
+                           std::vector<Word> &selected, std::vector<double> &intervals, std::ostream &out) {
+            double total = 0, last = 0;
+            for (double ft: fitness) {
+                total += ft;
+            }
+
+            intervals.clear();
+            for (double ft: fitness) {
+                last += ft / total;
+                intervals.push_back(last);
+            }
+
+            selected.clear();
+            for (size_t i = 0; i < count; i++) {
+                double u = uniform(rng);
+                size_t index = std::upper_bound(intervals.begin(), intervals.end(), u) - intervals.begin();
+                index = std::min(index, population.size() - 1);
+                selected.push_back(population[index]);
+                if constexpr (Trace::enabled) {
+                    out << "u = " << u << " we choose the organism " << index + 1 << std::endl;
+                }
+            }
+        }
+    };
+
+    /*
+     * Selection policy: binary tournaments, where the fitter of two random organisms is selected.
+     */
+    struct TournamentSelection {
+        template<typename Word, unsigned int Width, typename Trace>
+        static void select(const std::vector<Word> &population, const std::vector<double> &fitness, size_t count,
+                           std::vector<Word> &selected, std::vector<double> &, std::ostream &out) {
+            auto size = (uint32_t) population.size();
+            selected.clear();
+            for (size_t i = 0; i < count; i++) {
+                size_t a = bounded(rng, size);
+                size_t b = bounded(rng, size);
+                size_t index = fitness[b] > fitness[a] ? b : a;
+                selected.push_back(population[index]);
+                if constexpr (Trace::enabled) {
+                    out << "Organism " << a + 1 << " against organism " << b + 1 << ", we choose the organism "
+                        << index + 1 << std::endl;
+                }
+            }
+        }
+    };
+
+    /*
+     * Cross-over policy: organisms are chosen with the cross-over probability and paired in order. Every pair
+     * swaps the genes after a random split point, with the same operator as Organism::cross. If an organism is left
+     * without a pair, it is paired with the first chosen organism.
+     */
+    struct SinglePointCrossover {
+        template<typename Word, unsigned int Width, typename Trace>
+        static void apply(std::vector<Word> &population, double probability, std::vector<size_t> &chosen,
+                          std::ostream &out) {
+            chosen.clear();
+            for (size_t index = 0; index < population.size(); index++) {
+                if (uniform(rng) < probability) {
+                    chosen.push_back(index);
+                }
+            }
+
+            size_t index = 0;
+            while (index + 1 < chosen.size()) {
+                cross<Word, Trace>(population[chosen[index]], population[chosen[index + 1]], bounded(rng, Width),
+                                   out);
+                index += 2;
+            }
+            if (index < chosen.size()) {
+                cross<Word, Trace>(population[chosen[index]], population[chosen[0]], bounded(rng, Width), out);
+            }
+        }
+
+        template<typename Word, typename Trace>
+        static void cross(Word &a, Word &b, unsigned int split_point, std::ostream &out) {
+            if constexpr (Trace::enabled) {
+                out << "Split point: " << split_point << std::endl;
+            }
+            cross_chromosomes(a, b, split_point);
+        }
+    };
+
+    /*
+     * Cross-over policy: organisms are chosen with the cross-over probability and paired in order. Every pair
+     * swaps each gene with probability 1/2.
+     */
+    struct UniformCrossover {
+        template<typename Word, unsigned int Width, typename Trace>
+        static void apply(std::vector<Word> &population, double probability, std::vector<size_t> &chosen,
+                          std::ostream &out) {
+            chosen.clear();
+            for (size_t index = 0; index < population.size(); index++) {
+                if (uniform(rng) < probability) {
+                    chosen.push_back(index);
+                }
+            }
+
+            for (size_t index = 0; index + 1 < chosen.size(); index += 2) {
+                Word mask = (Word) random_bitvector(Width);
+                Word &a = population[chosen[index]];
+                Word &b = population[chosen[index + 1]];
+                Word swapped = (a ^ b) & mask;
+                a ^= swapped;
+                b ^= swapped;
+                if constexpr (Trace::enabled) {
+                    out << "Swap mask: " << bitvector_to_string(mask, Width) << std::endl;
+                }
+            }
+        }
+    };
+
+    /*
+     * Mutation policy: every organism is chosen with the mutation probability, and a random gene of every chosen
+     * organism is flipped, like Organism::mutate does.
+     */
+    struct BitFlipMutation {
+        template<typename Word, unsigned int Width, typename Trace>
+        static void apply(std::vector<Word> &population, double probability, std::vector<size_t> &chosen,
+                          std::ostream &out) {
+            chosen.clear();
+            for (size_t i = 0; i < population.size(); i++) {
+                if (uniform(rng) < probability) {
+                    chosen.push_back(i);
+                }
+            }
+            for (size_t index: chosen) {
+                unsigned int gene = bounded(rng, Width);
+                flip_gene(population[index], gene);
+                if constexpr (Trace::enabled) {
+                    out << "Mutating organism " << index + 1 << ", gene " << gene << std::endl;
+                }
+            }
+        }
+    };
+
+    /*
+     * A genetic optimiser whose configuration is fixed at compile time: the type of the chromosomes, their width,
+     * the selection, cross-over and mutation policies and the tracing level are template parameters, and so is
+     * the type of the function, so that it can be inlined. An epoch then compiles to straight-line code,
+     * without runtime checks of the configuration or indirect calls.
+     * With the default policies, an epoch does exactly what an epoch of Optimiser does, drawing the same random
+     * numbers in the same order.
+     */
+    template<typename Word, unsigned int Width,
+            typename Selection = RouletteSelection,
+            typename Crossover = SinglePointCrossover,
+            typename Mutation = BitFlipMutation,
+            typename Trace = NoTrace,
+            typename Function = double (*)(double)>
+    class Engine {
+        static_assert(std::is_unsigned_v<Word>, "The chromosome must be an unsigned integer");
+        static_assert(Width > 0 && Width <= std::numeric_limits<Word>::digits,
+                      "The chromosome does not fit in the given word");
+        static_assert(Width <= std::numeric_limits<bitvector>::digits, "Random chromosomes are bitvectors");
+
+    private:
+        Function f;
+        unsigned int population_size;
+        range domain;
+        double cross_probability;
+        double mutation_probability;
+
+        /*
+         * The size of a discrete interval.
+         */
+        double step_size;
+
+        /*
+         * The stream the trace is written to, and the stream that discards it, if the output is disabled.
+         */
+        std::ostream *output;
+        std::unique_ptr<std::ostream> discarded;
+
+        /*
+         * The current population, the fitness of every organism and the scratch buffers of the stages.
+         * They are allocated once, in the constructor.
+         */
+        std::vector<Word> population;
+        std::vector<Word> selected;
+        std::vector<double> fitness;
+        std::vector<double> intervals;
+        std::vector<size_t> chosen;
+
+        /*
+         * Computes the fitness of every organism and returns the index of the fittest one.
+         */
+        size_t evaluate() {
+            fitness.clear();
+            size_t best = 0;
+            for (size_t i = 0; i < population.size(); i++) {
+                fitness.push_back(f(to_domain(population[i])));
+                if (fitness[i] > fitness[best]) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+    public:
+        Engine(Function _function, unsigned int _population_size, range _domain, double _cross_probability,
+               double _mutation_probability) :
+                f(_function),
+                population_size(_population_size),
+                domain(_domain),
+                cross_probability(_cross_probability),
+                mutation_probability(_mutation_probability),
+                step_size(discrete_step(_domain, Width)),
+                output(&std::cout) {
+            population.reserve(population_size);
+            selected.reserve(population_size);
+            fitness.reserve(population_size);
+            intervals.reserve(population_size);
+            chosen.reserve(population_size);
+        }
+
+        /*
+         * Generates the initial population. It consists of randomly generated organisms.
+         */
+        void initialise() {
+            population.clear();
+            for (unsigned int i = 0; i < population_size; i++) {
+                population.push_back((Word) random_bitvector(Width));
+            }
+        }
+
+        /*
+         * Replaces the population with the next generation: the fittest organism, and population_size - 1 organisms
+         * created by selection, cross-over and mutation.
+         */
+        void step() {
+            if (population.empty()) {
+                return;
+            }
+            Word best = population[evaluate()];
+
+            Selection::template select<Word, Width, Trace>(population, fitness, population.size() - 1, selected,
+                                                           intervals, *output);
+            if constexpr (Trace::enabled) {
+                *output << "After selection: " << std::endl;
+                show_chromosomes<Word, Width>(selected, *output);
+            }
+
+            Crossover::template apply<Word, Width, Trace>(selected, cross_probability, chosen, *output);
+            if constexpr (Trace::enabled) {
+                *output << "After crossing over: " << std::endl;
+                show_chromosomes<Word, Width>(selected, *output);
+            }
+
+            Mutation::template apply<Word, Width, Trace>(selected, mutation_probability, chosen, *output);
+            if constexpr (Trace::enabled) {
+                *output << "After mutation: " << std::endl;
+                show_chromosomes<Word, Width>(selected, *output);
+            }
+
+            selected.push_back(best);
+            std::swap(population, selected);
+        }
+
+        /*
+         * Simulates the given number of epochs, starting from a random population, and returns the x for which
+         * the best organism found is maximal.
+         */
+        double run(unsigned int epochs) {
+            initialise();
+            for (unsigned int e = 0; e < epochs; e++) {
+                step();
+            }
+            return to_domain(population[evaluate()]);
+        }
+
+        /*
+         * Sets the stream the trace is written to. It is std::cout by default, and null disables the output.
+         * Nothing is written unless the Trace policy enables it.
+         */
+        void set_output(std::ostream *stream) {
+            if (stream == nullptr) {
+                // A stream without a buffer discards everything written to it.
+                discarded = std::make_unique<std::ostream>(nullptr);
+                stream = discarded.get();
+            }
+            output = stream;
+        }
+
+        /*
+         * Returns the current population.
+         */
+        const std::vector<Word> &get_population() const {
+            return population;
+        }
+
+        /*
+         * Converts the given chromosome to a number in the domain.
+         */
+        double to_domain(Word chromosome) const {
+            return decode_chromosome(chromosome, domain, step_size);
+        }
+    };
+}
+
+#endif //GENETICSIMULATION_ENGINE_H
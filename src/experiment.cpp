@@ -0,0 +1,444 @@
+//
+// Created by visan on 5/25/23.
+//
+
+#include "experiment.h"
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cmath>
+#include<exception>
+#include<fstream>
+#include<iomanip>
+#include<limits>
+#include<sstream>
+#include<stdexcept>
+#include<thread>
+#include "objectives.h"
+#include "optimiser.h"
+
+namespace GeneticSimulation {
+    // The parameters that accept several values, in the order in which the grid is enumerated.
+    static const std::vector<std::string> grid_keys = {"objective", "population", "left", "right", "precision",
+                                                       "cross", "mutation", "epochs", "elites", "memetic",
+                                                       "target", "seed", "replacement", "lambda", "niching",
+                                                       "radius", "alpha", "rates"};
+
+    // The values of the settings that are names.
+    static const std::map<std::string, std::vector<std::string>> names = {
+            {"format",      {"csv",          "json"}},
+            {"replacement", {"generational", "plus",    "comma",    "age"}},
+            {"niching",     {"none",         "sharing", "clearing", "crowding"}},
+            {"rates",       {"fixed",        "one_fifth", "diversity"}},
+    };
+
+    // The settings that take a single value.
+    static const std::vector<std::string> setting_keys = {"runs", "threads", "summary", "format", "telemetry"};
+
+    /*
+     * Removes the whitespace at both ends of the given string.
+     */
+    static std::string trim(const std::string &s) {
+        size_t first = s.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            return "";
+        }
+        size_t last = s.find_last_not_of(" \t\r");
+        return s.substr(first, last - first + 1);
+    }
+
+    static double parse_double(const std::string &s) {
+        size_t end = 0;
+        double result;
+        try {
+            result = std::stod(s, &end);
+        } catch (const std::logic_error &) {
+            end = 0;
+        }
+        if (s.empty() || end != s.size()) {
+            throw std::invalid_argument("Not a number: " + s);
+        }
+        return result;
+    }
+
+    static unsigned long parse_unsigned(const std::string &s) {
+        size_t end = 0;
+        unsigned long result;
+        try {
+            result = std::stoul(s, &end);
+        } catch (const std::logic_error &) {
+            end = 0;
+        }
+        if (s.empty() || end != s.size() || s[0] == '-') {
+            throw std::invalid_argument("Not a non-negative integer: " + s);
+        }
+        return result;
+    }
+
+    /*
+     * Throws std::invalid_argument if the given value of the given setting is invalid on its own.
+     */
+    static void check_value(const std::string &key, const std::string &v) {
+        auto fail = [&key, &v](const std::string &reason) {
+            throw std::invalid_argument("Invalid " + key + " = " + v + ": " + reason);
+        };
+        if (key == "objective") {
+            find_objective(v);
+        } else if (names.count(key) != 0) {
+            const std::vector<std::string> &allowed = names.at(key);
+            if (std::find(allowed.begin(), allowed.end(), v) == allowed.end()) {
+                fail("unknown " + key);
+            }
+        } else if (key == "left" || key == "right") {
+            if (!std::isfinite(parse_double(v))) {
+                fail("the domain must be finite");
+            }
+        } else if (key == "cross" || key == "mutation") {
+            double probability = parse_double(v);
+            if (!(probability >= 0 && probability <= 1)) {
+                fail("a probability must be in [0, 1]");
+            }
+        } else if (key == "radius" || key == "alpha") {
+            double x = parse_double(v);
+            if (!(x > 0) || std::isinf(x)) {
+                fail("it must be positive");
+            }
+        } else if (key == "target") {
+            if (std::isnan(parse_double(v))) {
+                fail("not a number");
+            }
+        } else if (key == "precision") {
+            if (parse_unsigned(v) > 9) {
+                fail("at most 9 decimals are supported");
+            }
+        } else if (key != "summary" && key != "telemetry") {
+            // The integer settings are stored as unsigned int.
+            unsigned long n = parse_unsigned(v);
+            if (n > std::numeric_limits<unsigned int>::max()) {
+                fail("it must be at most " + std::to_string(std::numeric_limits<unsigned int>::max()));
+            }
+            if (key == "population" && n < 2) {
+                fail("the population needs at least 2 organisms");
+            }
+        }
+    }
+
+    Experiment::Experiment() {
+        parameters = {
+                {"objective",  {"g"}},
+                {"population", {"10"}},
+                {"left",       {}},
+                {"right",      {}},
+                {"precision",  {"6"}},
+                {"cross",      {"0.25"}},
+                {"mutation",   {"0.01"}},
+                {"epochs",     {"1000"}},
+                {"elites",     {"1"}},
+                {"memetic",    {"0"}},
+                {"target",     {"inf"}},
+                {"seed",       {"1"}},
+                {"replacement", {"generational"}},
+                {"lambda",     {"0"}},
+                {"niching",    {"none"}},
+                {"radius",     {"0.1"}},
+                {"alpha",      {"1"}},
+                {"rates",      {"fixed"}},
+                {"runs",       {"1"}},
+                {"threads",    {"0"}},
+                {"summary",    {"-"}},
+                {"format",     {"csv"}},
+                {"telemetry",  {""}},
+        };
+    }
+
+    void Experiment::set(const std::string &key, const std::string &value) {
+        auto parameter = parameters.find(key);
+        if (parameter == parameters.end()) {
+            throw std::invalid_argument("Unknown setting: " + key);
+        }
+
+        std::vector<std::string> values;
+        bool grid = std::find(grid_keys.begin(), grid_keys.end(), key) != grid_keys.end();
+        if (grid) {
+            std::istringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                values.push_back(trim(item));
+            }
+        } else {
+            values.push_back(trim(value));
+        }
+        if (grid && values.empty()) {
+            throw std::invalid_argument("No value for " + key);
+        }
+
+        // Check the values now, so that a typo does not fail the experiment halfway through.
+        for (const std::string &v: values) {
+            check_value(key, v);
+        }
+        parameter->second = values;
+    }
+
+    void Experiment::load(std::istream &is) {
+        std::string line;
+        for (unsigned int number = 1; std::getline(is, line); number++) {
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) {
+                continue;
+            }
+            try {
+                size_t equals = line.find('=');
+                if (equals == std::string::npos) {
+                    throw std::invalid_argument("Expected key = value: " + line);
+                }
+                set(trim(line.substr(0, equals)), line.substr(equals + 1));
+            } catch (const std::invalid_argument &error) {
+                throw std::invalid_argument("Line " + std::to_string(number) + ": " + error.what());
+            }
+        }
+    }
+
+    const std::string &Experiment::value(const std::string &key) const {
+        return parameters.at(key).front();
+    }
+
+    std::vector<job> Experiment::jobs() const {
+        // Enumerate the combinations like an odometer: choice[k] is the chosen value of grid_keys[k].
+        // Unset parameters (left and right) have a single, empty choice.
+        std::vector<size_t> choice(grid_keys.size(), 0);
+        auto choices = [this](size_t k) {
+            return std::max<size_t>(parameters.at(grid_keys[k]).size(), 1);
+        };
+        auto chosen = [this, &choice](size_t k) -> std::string {
+            const std::vector<std::string> &values = parameters.at(grid_keys[k]);
+            return values.empty() ? "" : values[choice[k]];
+        };
+
+        unsigned long runs = parse_unsigned(value("runs"));
+
+        // Every seed of the grid starts runs consecutive seeds, and a seed must not be run twice.
+        std::vector<unsigned long> seeds;
+        for (const std::string &seed: parameters.at("seed")) {
+            seeds.push_back(parse_unsigned(seed));
+        }
+        std::sort(seeds.begin(), seeds.end());
+        for (size_t i = 1; i < seeds.size(); i++) {
+            if (seeds[i] < seeds[i - 1] + std::max<unsigned long>(runs, 1)) {
+                throw std::invalid_argument("Invalid seed: the runs of seed " + std::to_string(seeds[i - 1]) +
+                                            " and seed " + std::to_string(seeds[i]) + " overlap");
+            }
+        }
+
+        std::vector<job> result;
+        while (true) {
+            const objective &o = find_objective(chosen(0));
+            job j{};
+            j.objective = o.name;
+            j.population_size = parse_unsigned(chosen(1));
+            j.domain = o.domain;
+            if (!chosen(2).empty()) {
+                j.domain.left = parse_double(chosen(2));
+            }
+            if (!chosen(3).empty()) {
+                j.domain.right = parse_double(chosen(3));
+            }
+            j.precision = parse_unsigned(chosen(4));
+            j.cross_probability = parse_double(chosen(5));
+            j.mutation_probability = parse_double(chosen(6));
+            j.epochs = parse_unsigned(chosen(7));
+            j.elites = parse_unsigned(chosen(8));
+            j.memetic = parse_unsigned(chosen(9));
+            j.target_fitness = parse_double(chosen(10));
+            auto first_seed = (std::mt19937::result_type) parse_unsigned(chosen(11));
+            j.replacement = chosen(12);
+            j.lambda = parse_unsigned(chosen(13));
+            j.niching = chosen(14);
+            j.radius = parse_double(chosen(15));
+            j.alpha = parse_double(chosen(16));
+            j.rates = chosen(17);
+
+            // The checks that need several settings.
+            std::ostringstream domain;
+            domain << "[" << j.domain.left << ", " << j.domain.right << "]";
+            if (!(j.domain.left < j.domain.right)) {
+                throw std::invalid_argument("Invalid left, right: the domain " + domain.str() + " is empty");
+            }
+            double points = std::ceil((j.domain.right - j.domain.left) * std::pow(10.0, j.precision));
+            if (points > std::ldexp(1.0, max_bits)) {
+                throw std::invalid_argument("Invalid precision = " + std::to_string(j.precision) + ": the domain " +
+                                            domain.str() + " needs more than " + std::to_string(max_bits) +
+                                            " bits per chromosome");
+            }
+            for (unsigned long r = 0; r < runs; r++) {
+                j.index = result.size();
+                j.seed = first_seed + r;
+                result.push_back(j);
+            }
+
+            // Advance to the next combination, the last parameter changing fastest.
+            size_t k = grid_keys.size();
+            while (k > 0 && ++choice[k - 1] == choices(k - 1)) {
+                choice[k - 1] = 0;
+                k--;
+            }
+            if (k == 0) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    unsigned int Experiment::threads() const {
+        return parse_unsigned(value("threads"));
+    }
+
+    const std::string &Experiment::summary() const {
+        return value("summary");
+    }
+
+    const std::string &Experiment::format() const {
+        return value("format");
+    }
+
+    const std::string &Experiment::telemetry() const {
+        return value("telemetry");
+    }
+
+    job_result run_job(const job &configuration, const std::string &telemetry) {
+        auto start = std::chrono::steady_clock::now();
+        const objective &o = find_objective(configuration.objective);
+        Optimiser opt(o.function, configuration.population_size, configuration.domain, configuration.precision,
+                      configuration.cross_probability, configuration.mutation_probability, configuration.epochs);
+        opt.set_output(nullptr);
+        unsigned int lambda = configuration.lambda == 0 ? configuration.population_size : configuration.lambda;
+        if (configuration.replacement == "plus") {
+            opt.set_replacement(Replacement::plus(lambda));
+        } else if (configuration.replacement == "comma") {
+            opt.set_replacement(Replacement::comma(lambda));
+        } else if (configuration.replacement == "age") {
+            opt.set_replacement(Replacement::age(lambda));
+        } else {
+            opt.set_replacement(Replacement::generational(configuration.elites));
+        }
+        if (configuration.niching == "sharing") {
+            opt.set_niching(Niching::sharing(configuration.radius, configuration.alpha));
+        } else if (configuration.niching == "clearing") {
+            opt.set_niching(Niching::clearing(configuration.radius));
+        } else if (configuration.niching == "crowding") {
+            opt.set_niching(Niching::crowding(configuration.radius));
+        }
+        if (configuration.rates == "one_fifth") {
+            opt.set_rate_controller(std::make_unique<OneFifthRule>());
+        } else if (configuration.rates == "diversity") {
+            opt.set_rate_controller(std::make_unique<DiversityControl>());
+        }
+        opt.set_memetic(configuration.memetic);
+        opt.set_target_fitness(configuration.target_fitness);
+        opt.set_telemetry(!telemetry.empty());
+
+        rng.seed(configuration.seed);
+        double x = opt.optimise();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (!telemetry.empty()) {
+            std::ofstream os(telemetry + std::to_string(configuration.index) + ".csv");
+            if (!os) {
+                throw std::runtime_error("Could not write the telemetry of job " +
+                                         std::to_string(configuration.index));
+            }
+            os << std::setprecision(std::numeric_limits<double>::max_digits10);
+            os << "epoch,evaluations,max_fitness,average_fitness,diversity,cross_probability,mutation_probability\n";
+            for (const epoch_stats &stats: opt.get_telemetry()) {
+                os << stats.epoch << ',' << stats.evaluations << ',' << stats.max_fitness << ','
+                   << stats.average_fitness << ',' << stats.diversity << ',' << stats.cross_probability << ','
+                   << stats.mutation_probability << '\n';
+            }
+        }
+        return {configuration, x, o.function(x), opt.get_evaluations(), elapsed.count()};
+    }
+
+    std::vector<job_result> run_jobs(const std::vector<job> &jobs, unsigned int threads,
+                                     const std::string &telemetry) {
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        threads = (unsigned int) std::min<size_t>(threads, jobs.size());
+
+        std::vector<job_result> results(jobs.size());
+        std::atomic<size_t> next(0);
+        // The first error of a worker, rethrown once all the workers have stopped.
+        std::exception_ptr error;
+        std::atomic<bool> failed(false);
+
+        auto work = [&]() {
+            for (size_t i = next++; i < jobs.size() && !failed; i = next++) {
+                try {
+                    results[i] = run_job(jobs[i], telemetry);
+                } catch (...) {
+                    if (!failed.exchange(true)) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; t++) {
+            workers.emplace_back(work);
+        }
+        for (std::thread &worker: workers) {
+            worker.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return results;
+    }
+
+    /*
+     * Writes a double to a JSON document. Infinities are not valid JSON numbers, so they are written as null.
+     */
+    static void write_json_number(std::ostream &os, double value) {
+        if (std::isfinite(value)) {
+            os << value;
+        } else {
+            os << "null";
+        }
+    }
+
+    void write_summary(std::ostream &os, const std::vector<job_result> &results, const std::string &format) {
+        os << std::setprecision(std::numeric_limits<double>::max_digits10);
+        if (format == "csv") {
+            os << "job,objective,population,left,right,precision,cross,mutation,epochs,elites,memetic,target,seed,"
+                  "replacement,lambda,niching,radius,alpha,rates,x,fitness,evaluations,seconds\n";
+            for (const job_result &r: results) {
+                const job &j = r.configuration;
+                os << j.index << ',' << j.objective << ',' << j.population_size << ',' << j.domain.left << ','
+                   << j.domain.right << ',' << j.precision << ',' << j.cross_probability << ','
+                   << j.mutation_probability << ',' << j.epochs << ',' << j.elites << ',' << j.memetic << ','
+                   << j.target_fitness << ',' << j.seed << ',' << j.replacement << ',' << j.lambda << ','
+                   << j.niching << ',' << j.radius << ',' << j.alpha << ',' << j.rates << ',' << r.x << ','
+                   << r.fitness << ',' << r.evaluations << ',' << r.seconds << '\n';
+            }
+            return;
+        }
+
+        os << "[\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const job_result &r = results[i];
+            const job &j = r.configuration;
+            os << "  {\"job\": " << j.index << ", \"objective\": \"" << j.objective << "\", \"population\": "
+               << j.population_size << ", \"left\": " << j.domain.left << ", \"right\": " << j.domain.right
+               << ", \"precision\": " << j.precision << ", \"cross\": " << j.cross_probability
+               << ", \"mutation\": " << j.mutation_probability << ", \"epochs\": " << j.epochs
+               << ", \"elites\": " << j.elites << ", \"memetic\": " << j.memetic << ", \"target\": ";
+            write_json_number(os, j.target_fitness);
+            os << ", \"seed\": " << j.seed << ", \"replacement\": \"" << j.replacement << "\", \"lambda\": " << j.lambda
+               << ", \"niching\": \"" << j.niching << "\", \"radius\": " << j.radius << ", \"alpha\": " << j.alpha
+               << ", \"rates\": \"" << j.rates << "\", \"x\": " << r.x << ", \"fitness\": " << r.fitness
+               << ", \"evaluations\": " << r.evaluations << ", \"seconds\": " << r.seconds << "}"
+               << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        os << "]\n";
+    }
+}
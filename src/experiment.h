@@ -0,0 +1,176 @@
+//
+// Created by visan on 5/25/23.
+//
+
+#ifndef GENETICSIMULATION_EXPERIMENT_H
+#define GENETICSIMULATION_EXPERIMENT_H
+
+#include<iostream>
+#include<map>
+#include<random>
+#include<string>
+#include<vector>
+#include "defines.h"
+
+namespace GeneticSimulation {
+    /*
+     * The configuration of a single run of the optimiser.
+     */
+    struct job {
+        // The position of the job in the experiment.
+        size_t index;
+
+        // The name of a built-in objective (see objectives.h).
+        std::string objective;
+
+        unsigned int population_size;
+        range domain;
+        unsigned int precision;
+        double cross_probability;
+        double mutation_probability;
+        unsigned int epochs;
+
+        // The number of elites of the generational replacement, and the number of organisms refined by
+        // the memetic stage (0 disables it).
+        unsigned int elites;
+        unsigned int memetic;
+
+        // The run stops when this fitness is reached. It is infinite if there is no target.
+        double target_fitness;
+
+        // The seed of the random number generator of the thread that runs the job.
+        std::mt19937::result_type seed;
+
+        // The replacement strategy (generational, plus, comma or age), and the number of offspring of the plus,
+        // comma and age strategies. If it is 0, as many offspring as organisms are created.
+        std::string replacement = "generational";
+        unsigned int lambda = 0;
+
+        // The niching strategy (none, sharing, clearing or crowding), the niche radius and the sharing exponent.
+        std::string niching = "none";
+        double radius = 0.1;
+        double alpha = 1;
+
+        // How the operator probabilities are adjusted between epochs: fixed, one_fifth (OneFifthRule) or
+        // diversity (DiversityControl), with the default parameters of the controllers.
+        std::string rates = "fixed";
+    };
+
+    /*
+     * The outcome of a job.
+     */
+    struct job_result {
+        job configuration;
+
+        // The best point found and its fitness.
+        double x;
+        double fitness;
+
+        // The number of fitness evaluations and the wall-clock time of the run, in seconds.
+        unsigned long long evaluations;
+        double seconds;
+    };
+
+    /*
+     * This class describes a batch experiment: a grid of optimiser configurations, every one run with several
+     * seeds, and where the results go. It is configured with key = value settings, read from a configuration file
+     * (one setting per line, # starts a comment) or given on the command line.
+     *
+     * The grid parameters accept a comma separated list of values, and the experiment runs every combination:
+     *   objective   the name of a built-in objective                        (default g)
+     *   population  the population size                                     (default 10)
+     *   left, right the domain                                               (default: the domain of the objective)
+     *   precision   the number of decimals of the discrete points            (default 6)
+     *   cross       the cross-over probability                               (default 0.25)
+     *   mutation    the mutation probability                                 (default 0.01)
+     *   epochs      the number of epochs                                     (default 1000)
+     *   elites      the number of elites                                     (default 1)
+     *   memetic     the number of organisms refined by the memetic stage     (default 0)
+     *   target      the target fitness, or inf                               (default inf)
+     *   seed        the first seed                                           (default 1)
+     *   replacement generational, plus, comma or age                         (default generational)
+     *   lambda      the offspring of plus, comma and age, 0 for population   (default 0)
+     *   niching     none, sharing, clearing or crowding                      (default none)
+     *   radius      the niche radius                                         (default 0.1)
+     *   alpha       the exponent of the sharing function                     (default 1)
+     *   rates       fixed, one_fifth or diversity                            (default fixed)
+     * The other settings take a single value:
+     *   runs        the number of seeds per combination: seed, seed + 1 ...  (default 1)
+     *   threads     the number of jobs run in parallel, 0 for one per core   (default 0)
+     *   summary     the file the summary is written to, - for stdout         (default -)
+     *   format      the format of the summary, csv or json                   (default csv)
+     *   telemetry   if it is set, the statistics of every epoch of job i are written to <telemetry>i.csv
+     * The values are checked when they are set: the population has at least 2 organisms, the integers fit in
+     * an unsigned int, the probabilities are in [0, 1], the precision is at most 9, and the radius and alpha are
+     * positive. The combinations are checked when the jobs are created: left must be less than right, the discrete
+     * points of the domain must fit in a chromosome of at most max_bits bits, and the seeds of the grid must be at
+     * least runs apart, so that no seed is run twice.
+     */
+    class Experiment {
+    public:
+        /*
+         * The widest chromosome a job may use.
+         */
+        static constexpr unsigned int max_bits = 30;
+
+    private:
+        std::map<std::string, std::vector<std::string>> parameters;
+
+        /*
+         * Returns the single value of the given setting.
+         */
+        const std::string &value(const std::string &key) const;
+
+    public:
+        /*
+         * Creates an experiment with the default settings: a single run of g, like main.
+         */
+        Experiment();
+
+        /*
+         * Sets the given setting. Throws std::invalid_argument if the key is unknown or a value is invalid.
+         */
+        void set(const std::string &key, const std::string &value);
+
+        /*
+         * Reads the settings from a configuration file. Throws std::invalid_argument if a line is invalid, with
+         * the number of the line in the message.
+         */
+        void load(std::istream &is);
+
+        /*
+         * Returns the jobs of the experiment: every combination of the grid parameters, once per seed.
+         * Throws std::invalid_argument if a combination is invalid, before any job is run.
+         */
+        std::vector<job> jobs() const;
+
+        unsigned int threads() const;
+
+        const std::string &summary() const;
+
+        const std::string &format() const;
+
+        const std::string &telemetry() const;
+    };
+
+    /*
+     * Runs the given job in the calling thread. The progress output of the optimiser is disabled. If telemetry is
+     * not empty, the statistics of every epoch are written to <telemetry><index>.csv.
+     */
+    job_result run_job(const job &configuration, const std::string &telemetry = "");
+
+    /*
+     * Runs the given jobs on the given number of threads (0 for one per core), and returns their results in
+     * the order of the jobs. Every job seeds the generator of its thread, so the results do not depend on
+     * the number of threads.
+     */
+    std::vector<job_result> run_jobs(const std::vector<job> &jobs, unsigned int threads,
+                                     const std::string &telemetry = "");
+
+    /*
+     * Writes the given results to the given stream, one record per job, in the given format (csv or json).
+     */
+    void write_summary(std::ostream &os, const std::vector<job_result> &results, const std::string &format);
+}
+
+#endif //GENETICSIMULATION_EXPERIMENT_H
@@ -0,0 +1,52 @@
+//
+// Created by visan on 5/15/23.
+//
+
+#include "local_search.h"
+
+namespace GeneticSimulation {
+    double hill_climb(Organism &organism, double fitness, const std::function<double(const Organism &)> &evaluate,
+                      unsigned int max_passes) {
+        unsigned int size = organism.get_chromosome_size();
+        // The largest chromosome value.
+        bitvector maximum = size >= 64 ? ~(bitvector) 0 : ((bitvector) 1 << size) - 1;
+
+        for (unsigned int pass = 0; pass < max_passes; pass++) {
+            bool improved = false;
+
+            for (unsigned int gene = size; gene-- > 0;) {
+                bitvector step = (bitvector) 1 << gene;
+
+                // Keep moving in the same direction while it improves the fitness.
+                bool moved = true;
+                while (moved) {
+                    moved = false;
+                    bitvector current = organism.get_chromosome();
+
+                    for (int direction = 0; direction < 2 && !moved; direction++) {
+                        if (direction == 0 && current > maximum - step) {
+                            continue;
+                        }
+                        if (direction == 1 && current < step) {
+                            continue;
+                        }
+                        organism.set_chromosome(direction == 0 ? current + step : current - step);
+                        double candidate = evaluate(organism);
+                        if (candidate > fitness) {
+                            fitness = candidate;
+                            moved = improved = true;
+                        } else {
+                            // Undo the move.
+                            organism.set_chromosome(current);
+                        }
+                    }
+                }
+            }
+
+            if (!improved) {
+                break;
+            }
+        }
+        return fitness;
+    }
+}
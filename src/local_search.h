@@ -0,0 +1,25 @@
+//
+// Created by visan on 5/15/23.
+//
+
+#ifndef GENETICSIMULATION_LOCAL_SEARCH_H
+#define GENETICSIMULATION_LOCAL_SEARCH_H
+
+#include<functional>
+#include "organism.h"
+
+namespace GeneticSimulation {
+    /*
+     * Improves the given organism with a compass search over the value of its chromosome, which is the
+     * decoded position in the domain. Starting with a step of half the chromosome range, the search
+     * tries to move the chromosome by +step and -step and keeps the move if it increases the fitness,
+     * otherwise it halves the step. Unlike flipping single genes, this does not get stuck when a better
+     * neighbour differs in many genes (for example 0111 and 1000).
+     * The search ends after a step of 1 fails to improve, or after max_passes sweeps over all step sizes.
+     * The fitness parameter is the fitness of the organism on entry, and the new fitness is returned.
+     */
+    double hill_climb(Organism &organism, double fitness, const std::function<double(const Organism &)> &evaluate,
+                      unsigned int max_passes);
+}
+
+#endif //GENETICSIMULATION_LOCAL_SEARCH_H
@@ -0,0 +1,149 @@
+//
+// Created by visan on 5/16/23.
+//
+
+#include "multi_optimiser.h"
+#include "sampling.h"
+#include<algorithm>
+#include<cmath>
+
+namespace GeneticSimulation {
+    MultiOptimiser::MultiOptimiser(std::function<objective_vector(double)> _function,
+                                   unsigned int _num_objectives,
+                                   unsigned int _population_size,
+                                   range _domain,
+                                   unsigned int _precision,
+                                   double _cross_probability,
+                                   double _mutation_probability,
+                                   unsigned int _epochs) :
+            f(std::move(_function)),
+            num_objectives(std::min(_num_objectives, max_objectives)),
+            population_size(_population_size),
+            domain(_domain),
+            cross_probability(_cross_probability),
+            mutation_probability(_mutation_probability),
+            epochs(_epochs) {
+
+        // The chromosomes are encoded the same way as in the single-objective optimiser.
+        bits_per_chromosome = chromosome_bits(domain, _precision);
+        step_size = discrete_step(domain, bits_per_chromosome);
+    }
+
+    size_t MultiOptimiser::tournament() const {
+        auto size = (uint32_t) rank.size();
+        size_t a = bounded(rng, size);
+        size_t b = bounded(rng, size);
+        if (rank[a] != rank[b]) {
+            return rank[a] < rank[b] ? a : b;
+        }
+        return distance[a] >= distance[b] ? a : b;
+    }
+
+    void MultiOptimiser::offspring() {
+        children.clear();
+        while (children.size() < population_size) {
+            Organism a = population[tournament()];
+            Organism b = population[tournament()];
+
+            if (uniform(rng) < cross_probability) {
+                a.cross(b, bounded(rng, bits_per_chromosome));
+            }
+            if (uniform(rng) < mutation_probability) {
+                a.mutate(bounded(rng, bits_per_chromosome));
+            }
+            if (uniform(rng) < mutation_probability) {
+                b.mutate(bounded(rng, bits_per_chromosome));
+            }
+            children.push_back(a);
+            if (children.size() < population_size) {
+                children.push_back(b);
+            }
+        }
+    }
+
+    std::vector<pareto_point> MultiOptimiser::optimise() {
+        population.clear();
+        values.clear();
+        for (unsigned int i = 0; i < population_size; i++) {
+            population.push_back(Organism::random_organism(bits_per_chromosome));
+            values.push_back(f(to_domain(population.back())));
+        }
+
+        distance.assign(population_size, 0);
+        non_dominated_sort(values, num_objectives, fronts, rank, order, staircases);
+        for (const std::vector<size_t> &front: fronts) {
+            crowding_distance(values, num_objectives, front, distance, sorted);
+        }
+
+        // The combined population holds the parents and their offspring.
+        children.reserve(population_size);
+        combined.reserve(2 * population_size);
+        combined_values.reserve(2 * population_size);
+        combined_distance.reserve(2 * population_size);
+        next_rank.reserve(population_size);
+        for (unsigned int e = 0; e < epochs; e++) {
+            // Parents and offspring compete for a place in the next generation.
+            offspring();
+            combined = population;
+            combined_values = values;
+            for (const Organism &child: children) {
+                combined.push_back(child);
+                combined_values.push_back(f(to_domain(child)));
+            }
+
+            non_dominated_sort(combined_values, num_objectives, fronts, rank, order, staircases);
+            combined_distance.assign(combined.size(), 0);
+
+            population.clear();
+            values.clear();
+            distance.clear();
+            next_rank.clear();
+            for (std::vector<size_t> &front: fronts) {
+                if (population.size() == population_size) {
+                    break;
+                }
+                crowding_distance(combined_values, num_objectives, front, combined_distance, sorted);
+
+                size_t room = population_size - population.size();
+                if (front.size() > room) {
+                    // The front does not fit, so keep its least crowded points.
+                    std::nth_element(front.begin(), front.begin() + (long) room, front.end(),
+                                     [this](size_t a, size_t b) {
+                                         return combined_distance[a] > combined_distance[b];
+                                     });
+                    front.resize(room);
+                }
+                for (size_t index: front) {
+                    population.push_back(combined[index]);
+                    values.push_back(combined_values[index]);
+                    distance.push_back(combined_distance[index]);
+                    next_rank.push_back(rank[index]);
+                }
+            }
+            std::swap(rank, next_rank);
+        }
+
+        // Return the first front, without duplicates.
+        std::vector<pareto_point> result;
+        for (size_t i = 0; i < population.size(); i++) {
+            if (rank[i] == 0) {
+                result.push_back({to_domain(population[i]), values[i]});
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const pareto_point &a, const pareto_point &b) {
+            return a.x < b.x;
+        });
+        result.erase(std::unique(result.begin(), result.end(), [](const pareto_point &a, const pareto_point &b) {
+            return a.x == b.x;
+        }), result.end());
+        return result;
+    }
+
+    unsigned int MultiOptimiser::get_bits_per_chromosome() const {
+        return bits_per_chromosome;
+    }
+
+    double MultiOptimiser::to_domain(const Organism &organism) const {
+        return decode_chromosome(organism.get_chromosome(), domain, step_size);
+    }
+}
@@ -0,0 +1,140 @@
+//
+// Created by visan on 5/16/23.
+//
+
+#ifndef GENETICSIMULATION_MULTI_OPTIMISER_H
+#define GENETICSIMULATION_MULTI_OPTIMISER_H
+
+#include<functional>
+#include<vector>
+#include "organism.h"
+#include "defines.h"
+#include "pareto.h"
+
+namespace GeneticSimulation {
+    /*
+     * A point of the Pareto front found by the multi-objective optimiser.
+     */
+    struct pareto_point {
+        double x;
+        objective_vector objectives;
+    };
+
+    /*
+     * This class finds the Pareto front of a function with up to max_objectives objectives, which are maximised,
+     * over a given range. It implements NSGA-II on top of the same chromosome encoding, cross-over and mutation
+     * as the single-objective optimiser.
+     */
+    class MultiOptimiser {
+    private:
+        /*
+         * The function to optimise. It returns the values of all objectives for a given x.
+         */
+        std::function<objective_vector(double)> f;
+
+        /*
+         * The number of objectives returned by the function.
+         */
+        unsigned int num_objectives;
+
+        /*
+         * The size of every generation.
+         */
+        unsigned int population_size;
+
+        /*
+         * The domain in which we search for the Pareto front.
+         */
+        range domain;
+
+        /*
+         * The probability of two parents to be crossed-over.
+         */
+        double cross_probability;
+
+        /*
+         * The probability of an offspring to mutate.
+         */
+        double mutation_probability;
+
+        /*
+         * The number of epochs the optimiser will simulate.
+         */
+        unsigned int epochs;
+
+        /*
+         * The number of bits needed to represent a chromosome.
+         */
+        unsigned int bits_per_chromosome;
+
+        /*
+         * The size of a discrete interval.
+         */
+        double step_size;
+
+        /*
+         * The current population, the values of its objectives, and the rank and the crowding distance of every
+         * organism.
+         */
+        std::vector<Organism> population;
+        std::vector<objective_vector> values;
+        std::vector<unsigned int> rank;
+        std::vector<double> distance;
+
+        /*
+         * The scratch buffers of an epoch: the offspring, the parents and the offspring together with the values of
+         * their objectives and their crowding distances, the fronts of the combined population, the ranks of the
+         * survivors, and the scratch space of the sort and of the crowding distances. They are kept between epochs,
+         * so that their memory is reused.
+         */
+        std::vector<Organism> children;
+        std::vector<Organism> combined;
+        std::vector<objective_vector> combined_values;
+        std::vector<double> combined_distance;
+        std::vector<std::vector<size_t>> fronts;
+        std::vector<unsigned int> next_rank;
+        std::vector<size_t> order;
+        std::vector<staircase> staircases;
+        std::vector<size_t> sorted;
+
+        /*
+         * Picks one of two random organisms: the one on the better front or, if they are on the same front,
+         * the one in the less crowded region.
+         */
+        size_t tournament() const;
+
+        /*
+         * Creates population_size offspring of the current population, using tournament selection, cross-over
+         * and mutation. The offspring are stored in children.
+         */
+        void offspring();
+
+    public:
+        MultiOptimiser(std::function<objective_vector(double)> _function,
+                       unsigned int _num_objectives,
+                       unsigned int _population_size,
+                       range _domain,
+                       unsigned int _precision,
+                       double _cross_probability,
+                       double _mutation_probability,
+                       unsigned int _epochs);
+
+        /*
+         * This method approximates the Pareto front of the function. The returned points are mutually
+         * non-dominated and sorted by x.
+         */
+        std::vector<pareto_point> optimise();
+
+        /*
+         * Returns the number of bits needed to represent a chromosome.
+         */
+        unsigned int get_bits_per_chromosome() const;
+
+        /*
+         * Converts the given organism to a number in the given domain.
+         */
+        double to_domain(const Organism &organism) const;
+    };
+}
+
+#endif //GENETICSIMULATION_MULTI_OPTIMISER_H
@@ -0,0 +1,164 @@
+//
+// Created by visan on 5/23/23.
+//
+
+#include "niching.h"
+#include<algorithm>
+#include<cmath>
+#include<stdexcept>
+#include<string>
+
+namespace GeneticSimulation {
+    Niching::Niching(Strategy _strategy, double _radius, double _alpha) : strategy(_strategy), radius(_radius),
+                                                                          alpha(_alpha) {
+    }
+
+    Niching Niching::none() {
+        return {Strategy::none, 0, 1};
+    }
+
+    /*
+     * Throws std::invalid_argument if the given radius is not a positive number.
+     */
+    static void check_radius(double radius) {
+        if (!(radius > 0) || std::isinf(radius)) {
+            throw std::invalid_argument("The niche radius must be positive: " + std::to_string(radius));
+        }
+    }
+
+    Niching Niching::sharing(double radius, double alpha) {
+        check_radius(radius);
+        if (!(alpha > 0) || std::isinf(alpha)) {
+            throw std::invalid_argument("The sharing exponent must be positive: " + std::to_string(alpha));
+        }
+        return {Strategy::sharing, radius, alpha};
+    }
+
+    Niching Niching::clearing(double radius) {
+        check_radius(radius);
+        return {Strategy::clearing, radius, 1};
+    }
+
+    Niching Niching::crowding(double radius) {
+        check_radius(radius);
+        return {Strategy::crowding, radius, 1};
+    }
+
+    Niching::Strategy Niching::get_strategy() const {
+        return strategy;
+    }
+
+    double Niching::get_radius() const {
+        return radius;
+    }
+
+    double Niching::get_alpha() const {
+        return alpha;
+    }
+
+    /*
+     * Fills order with the indices of the points, sorted by point.
+     */
+    static void sort_points(const std::vector<double> &points, std::vector<size_t> &order) {
+        order.clear();
+        for (size_t i = 0; i < points.size(); i++) {
+            order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&points](size_t a, size_t b) {
+            return points[a] < points[b];
+        });
+    }
+
+    void share_fitness(const std::vector<double> &points, std::vector<double> &fitness, double radius, double alpha,
+                       std::vector<size_t> &order, std::vector<double> &prefix) {
+        size_t n = points.size();
+        sort_points(points, order);
+
+        if (alpha == 1) {
+            // prefix[i] is the sum of the first i sorted points.
+            prefix.clear();
+            prefix.push_back(0);
+            for (size_t i = 0; i < n; i++) {
+                prefix.push_back(prefix[i] + points[order[i]]);
+            }
+
+            // The points within the radius of the ith sorted point are the sorted points left..right-1.
+            // Sum of (1 - d / radius) = count - (sum of d) / radius, and the sum of the distances is
+            // (points on the left: count * x - their sum) + (points on the right: their sum - count * x).
+            size_t left = 0, right = 0;
+            for (size_t i = 0; i < n; i++) {
+                double x = points[order[i]];
+                while (points[order[left]] <= x - radius) {
+                    left++;
+                }
+                while (right < n && points[order[right]] < x + radius) {
+                    right++;
+                }
+                double below = (double) (i - left) * x - (prefix[i] - prefix[left]);
+                double above = (prefix[right] - prefix[i + 1]) - (double) (right - i - 1) * x;
+                double count = (double) (right - left) - (below + above) / radius;
+                fitness[order[i]] /= count;
+            }
+            return;
+        }
+
+        size_t left = 0;
+        for (size_t i = 0; i < n; i++) {
+            double x = points[order[i]];
+            while (points[order[left]] <= x - radius) {
+                left++;
+            }
+            double count = 0;
+            for (size_t j = left; j < n && points[order[j]] < x + radius; j++) {
+                count += 1 - std::pow(std::abs(points[order[j]] - x) / radius, alpha);
+            }
+            fitness[order[i]] /= count;
+        }
+    }
+
+    void niche_winners(const std::vector<double> &points, const std::vector<double> &fitness, double radius,
+                       std::vector<size_t> &winners, std::vector<size_t> &order, std::vector<size_t> &position,
+                       std::vector<char> &cleared) {
+        size_t n = points.size();
+        sort_points(points, order);
+        // position[i] is the position of the ith point in the sorted order.
+        position.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            position[order[i]] = i;
+        }
+        cleared.assign(n, 0);
+
+        // Reuse the winners buffer to visit the points in decreasing order of fitness.
+        winners.clear();
+        for (size_t i = 0; i < n; i++) {
+            winners.push_back(i);
+        }
+        // Ties are broken by index, so that the order is stable without the buffer std::stable_sort allocates.
+        std::sort(winners.begin(), winners.end(), [&fitness](size_t a, size_t b) {
+            if (fitness[a] != fitness[b]) {
+                return fitness[a] > fitness[b];
+            }
+            return a < b;
+        });
+
+        size_t count = 0;
+        for (size_t k = 0; k < n; k++) {
+            size_t i = winners[k];
+            if (cleared[i]) {
+                continue;
+            }
+            winners[count++] = i;
+            cleared[i] = 1;
+
+            // Clear the neighbours within the radius, on both sides.
+            double x = points[i];
+            for (size_t j = position[i] + 1; j < n && points[order[j]] - x < radius; j++) {
+                cleared[order[j]] = 1;
+            }
+            for (size_t j = position[i]; j > 0 && x - points[order[j - 1]] < radius; j--) {
+                cleared[order[j - 1]] = 1;
+            }
+        }
+        winners.resize(count);
+    }
+}
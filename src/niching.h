@@ -0,0 +1,86 @@
+//
+// Created by visan on 5/23/23.
+//
+
+#ifndef GENETICSIMULATION_NICHING_H
+#define GENETICSIMULATION_NICHING_H
+
+#include<cstddef>
+#include<vector>
+
+namespace GeneticSimulation {
+    /*
+     * This class describes how the optimiser preserves the diversity of the population, so that it can find
+     * several optima of a multimodal function in a single run instead of collapsing onto one peak. The strategies are:
+     * - sharing: the fitness of every organism is divided by its niche count, the sum of 1 - (d / radius)^alpha over
+     * the organisms at a distance d < radius from it, before the selection.
+     * - clearing: the fittest organism of every niche keeps its fitness, and the fitness of the other organisms
+     * within the radius is set to 0, before the selection.
+     * - crowding: deterministic crowding. The parents are paired at random, and every child competes with the
+     * closest of its two parents. It replaces it if it is fitter. The selection and the replacement strategy
+     * are not used.
+     * Distances are measured between decoded points of the domain. The chromosome encodes the point as a binary
+     * number, so the decoded points are ordered like the chromosomes, and niches are intervals of the domain.
+     * The radius is also used to tell the optima apart at the end of a run.
+     */
+    class Niching {
+    public:
+        enum class Strategy {
+            none, sharing, clearing, crowding
+        };
+
+    private:
+        Strategy strategy;
+        double radius;
+        double alpha;
+
+        Niching(Strategy _strategy, double _radius, double _alpha);
+
+    public:
+        /*
+         * No niching. It is the default.
+         */
+        static Niching none();
+
+        /*
+         * The other strategies throw std::invalid_argument if the radius or the sharing exponent alpha is not
+         * a positive number.
+         */
+
+        static Niching sharing(double radius, double alpha = 1);
+
+        static Niching clearing(double radius);
+
+        static Niching crowding(double radius);
+
+        Strategy get_strategy() const;
+
+        double get_radius() const;
+
+        double get_alpha() const;
+    };
+
+    /*
+     * Divides every fitness score by the niche count of the corresponding point. The points are sorted once,
+     * so that the neighbours of a point are the points next to it in the sorted order. With alpha = 1, the niche
+     * counts are computed from prefix sums of the sorted points in O(n log n). Otherwise, the neighbours within
+     * the radius are visited one by one.
+     * The order and prefix buffers are scratch space.
+     */
+    void share_fitness(const std::vector<double> &points, std::vector<double> &fitness, double radius, double alpha,
+                       std::vector<size_t> &order, std::vector<double> &prefix);
+
+    /*
+     * Visits the points in decreasing order of fitness. Every point that was not cleared yet is the winner of its
+     * niche, and the other points within the radius are cleared. Returns the indices of the winners, in decreasing
+     * order of fitness, in the winners vector. Winners are at least the radius apart.
+     * The points are sorted, so that only the neighbours of a winner are visited: a point can only be within
+     * the radius of two winners, so the visits take linear time after the sorts.
+     * The order, position and cleared buffers are scratch space.
+     */
+    void niche_winners(const std::vector<double> &points, const std::vector<double> &fitness, double radius,
+                       std::vector<size_t> &winners, std::vector<size_t> &order, std::vector<size_t> &position,
+                       std::vector<char> &cleared);
+}
+
+#endif //GENETICSIMULATION_NICHING_H
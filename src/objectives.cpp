@@ -0,0 +1,56 @@
+//
+// Created by visan on 5/25/23.
+//
+
+#include "objectives.h"
+#include<cmath>
+#include<stdexcept>
+
+namespace GeneticSimulation {
+    static double f(double x) {
+        return sin(0.25 * x) + sin(M_PI * 0.1 * x) + 2;
+    }
+
+    static double g(double x) {
+        double c = cos(x * x + x + 7);
+        double s = sin(x + 10);
+        return c * c - s + 5;
+    }
+
+    static double parabola(double x) {
+        return -x * x + x + 2;
+    }
+
+    static double rastrigin(double x) {
+        return 50 - (10 + x * x - 10 * cos(2 * M_PI * x));
+    }
+
+    static double ackley(double x) {
+        return 25 - (20 + M_E - 20 * exp(-0.2 * std::abs(x)) - exp(cos(2 * M_PI * x)));
+    }
+
+    static double schwefel(double x) {
+        return 1000 - (418.9829 - x * sin(sqrt(std::abs(x))));
+    }
+
+    const std::vector<objective> &objectives() {
+        static const std::vector<objective> registry = {
+                {"f",         f,         {0,       40}},
+                {"g",         g,         {-2,      4}},
+                {"parabola",  parabola,  {-1,      2}},
+                {"rastrigin", rastrigin, {-5.12,   5.12}},
+                {"ackley",    ackley,    {-32.768, 32.768}},
+                {"schwefel",  schwefel,  {-500,    500}},
+        };
+        return registry;
+    }
+
+    const objective &find_objective(const std::string &name) {
+        for (const objective &o: objectives()) {
+            if (o.name == name) {
+                return o;
+            }
+        }
+        throw std::invalid_argument("Unknown objective: " + name);
+    }
+}
@@ -0,0 +1,41 @@
+//
+// Created by visan on 5/25/23.
+//
+
+#ifndef GENETICSIMULATION_OBJECTIVES_H
+#define GENETICSIMULATION_OBJECTIVES_H
+
+#include<string>
+#include<vector>
+#include "defines.h"
+
+namespace GeneticSimulation {
+    /*
+     * A built-in objective: a real function to maximise and the domain it is usually searched in.
+     * The fitness must be positive for the roulette wheel selection, so the classic minimisation benchmarks
+     * are turned into maximisation problems by subtracting them from a constant.
+     */
+    struct objective {
+        std::string name;
+        double (*function)(double);
+        range domain;
+    };
+
+    /*
+     * The registry of built-in objectives:
+     * - f: sin(0.25x) + sin(0.1 pi x) + 2, on [0, 40].
+     * - g: cos^2(x^2 + x + 7) - sin(x + 10) + 5, on [-2, 4].
+     * - parabola: -x^2 + x + 2, on [-1, 2].
+     * - rastrigin: 50 - (10 + x^2 - 10cos(2 pi x)), on [-5.12, 5.12]. The maximum is 50, at 0.
+     * - ackley: 25 - (20 + e - 20exp(-0.2|x|) - exp(cos(2 pi x))), on [-32.768, 32.768]. The maximum is 25, at 0.
+     * - schwefel: 1000 - (418.9829 - x sin(sqrt|x|)), on [-500, 500]. The maximum is about 1000, at 420.9687.
+     */
+    const std::vector<objective> &objectives();
+
+    /*
+     * Returns the built-in objective with the given name. Throws std::invalid_argument if there is none.
+     */
+    const objective &find_objective(const std::string &name);
+}
+
+#endif //GENETICSIMULATION_OBJECTIVES_H
@@ -18,17 +18,29 @@ namespace GeneticSimulation {
             precision(_precision),
             cross_probability(_cross_probability),
             mutation_probability(_mutation_probability),
-            epochs(_epochs) {
+            configured_cross_probability(_cross_probability),
+            configured_mutation_probability(_mutation_probability),
+            epochs(_epochs),
+            evaluations(0),
+            output(&std::cout),
+            record_telemetry(false),
+            record_run(false),
+            recording{std::mt19937::default_seed, {}},
+            generation(0),
+            memetic_top_k(0),
+            memetic_interval(1),
+            memetic_passes(4),
+            target_fitness(std::numeric_limits<double>::infinity()),
+            saved_evaluations(0),
+            repairs(0),
+            replacement(Replacement::generational()),
+            niching(Niching::none()) {
 
-        // The number of discrete points in the domain.
-        // The formula is : (b-a) * 10^p
-        unsigned int num_discrete = ceil((domain.right - domain.left) * fast_pow(10, precision));
-
-        // Now compute the number of bits needed to represent a chromosome.
         // A chromosome is a point in the set of discrete points.
-        bits_per_chromosome = ceil_log(num_discrete);
+        bits_per_chromosome = chromosome_bits(domain, precision);
+        step_size = discrete_step(domain, bits_per_chromosome);
 
-        step_size = (domain.right - domain.left) / (1 << bits_per_chromosome);
+        workspace.reserve(population_size);
     }
 
 
@@ -40,160 +52,330 @@ namespace GeneticSimulation {
         return result;
     }
 
-    std::vector<Organism> Optimiser::selection(const std::vector<Organism> &organisms, bool verbose) const {
-        std::vector<double> fitness_score(organisms.size());
+    void Optimiser::evaluate(std::vector<Organism> &organisms, bool append) {
+        if (!append) {
+            if (workspace.fitness_current && workspace.fitness_score.size() == organisms.size()) {
+                // The scores were computed when the population was formed.
+                workspace.fitness_current = false;
+                return;
+            }
+            workspace.fitness_score.clear();
+            workspace.violation.clear();
+        }
+        workspace.fitness_current = false;
+        if (batch_evaluator) {
+            evaluate_batch(organisms);
+            return;
+        }
+        if (constraints.empty()) {
+            for (const Organism &o: organisms) {
+                workspace.fitness_score.push_back(fitness(o));
+            }
+            return;
+        }
+
+        for (Organism &o: organisms) {
+            double violation;
+            workspace.fitness_score.push_back(constrained_fitness(o, violation));
+            workspace.violation.push_back(violation);
+        }
+    }
+
+    void Optimiser::evaluate_batch(std::vector<Organism> &organisms) {
+        // Decode the organisms that have to be evaluated, so that they are evaluated in a single batch.
+        std::vector<double> &points = workspace.points;
+        points.clear();
+        // The position of the first score of this batch in the workspace.
+        size_t first = workspace.fitness_score.size();
+        for (Organism &o: organisms) {
+            if (!constraints.empty()) {
+                unsigned int failed = feasibility(o);
+                workspace.violation.push_back(failed);
+                if (failed != 0) {
+                    continue;
+                }
+            }
+            points.push_back(to_domain(o));
+        }
+
+        batch_evaluator(points, workspace.values);
+        evaluations += points.size();
+
+        size_t next = 0;
+        for (size_t i = 0; i < organisms.size(); i++) {
+            if (!constraints.empty() && workspace.violation[first + i] != 0) {
+                workspace.fitness_score.push_back(0);
+                continue;
+            }
+            workspace.fitness_score.push_back(workspace.values[next] - constraints.penalty(points[next]));
+            next++;
+        }
+    }
+
+    unsigned int Optimiser::feasibility(Organism &organism) {
+        double x = to_domain(organism);
+        unsigned int failed = constraints.failed_predicates(x);
+
+        if (failed != 0 && constraints.can_repair()) {
+            organism = from_domain(constraints.repair(x));
+            failed = constraints.failed_predicates(to_domain(organism));
+            repairs++;
+        }
+
+        if (failed != 0) {
+            // The function will not be evaluated for this organism.
+            saved_evaluations++;
+        }
+        return failed;
+    }
+
+    double Optimiser::constrained_fitness(Organism &organism, double &violation) {
+        unsigned int failed = feasibility(organism);
+        if (failed != 0) {
+            // Reject the organism without evaluating the function.
+            violation = failed;
+            return 0;
+        }
+
+        violation = 0;
+        return fitness(organism) - constraints.penalty(to_domain(organism));
+    }
+
+    bool Optimiser::better(size_t a, size_t b) const {
+        if (!constraints.empty() && workspace.violation[a] != workspace.violation[b]) {
+            return workspace.violation[a] < workspace.violation[b];
+        }
+        return workspace.fitness_score[a] > workspace.fitness_score[b];
+    }
+
+    template<typename Trace>
+    void Optimiser::selection(const std::vector<Organism> &organisms, size_t count) {
+        const std::vector<double> &fitness_score = workspace.fitness_score;
         double total = 0, last = 0;
 
-        // Precompute fitness scores and the total sum.
+        // Compute the total sum of the fitness scores.
         for (size_t i = 0; i < organisms.size(); i++) {
-            fitness_score[i] = fitness(organisms[i]);
             total += fitness_score[i];
         }
 
         // Generate the intervals.
-        std::vector<double> intervals;
+        std::vector<double> &intervals = workspace.intervals;
+        intervals.clear();
         for (size_t i = 0; i < organisms.size(); i++) {
             double probability = fitness_score[i] / total;
             intervals.push_back(last + probability);
             last += probability;
-            if (verbose) {
-                std::cout << "Organism " << i + 1 << " has a probability of " << fitness_score[i] / total << std::endl;
+            if constexpr (Trace::enabled) {
+                *output << "Organism " << i + 1 << " has a probability of " << fitness_score[i] / total << std::endl;
             }
         }
 
-        if (verbose) {
-            std::cout << std::endl;
-            std::cout << "Probability intervals: " << std::endl;
+        if constexpr (Trace::enabled) {
+            *output << std::endl;
+            *output << "Probability intervals: " << std::endl;
             for (double x: intervals) {
-                std::cout << x << " ";
+                *output << x << " ";
             }
-            std::cout << std::endl;
+            *output << std::endl;
         }
 
-        /* Then generate organism.size()-1 numbers in [0,1).
+        /* Then generate count numbers in [0,1).
          * For each generated number, we need to find out which interval
          * it resides in. So for a number x, we need to find the smallest y such that
          * y>x.
          */
 
-        std::vector<Organism> selected;
-        for (size_t i = 0; i < organisms.size() - 1; i++) {
-            // Random uniform number int [0 , 1).
-            std::uniform_real_distribution<> dist(0, 1);
-            double uniform = dist(rng);
+        // Random uniform numbers in [0 , 1).
+        std::vector<double> &uniforms = workspace.uniforms;
+        uniforms.resize(count);
+        fill_uniform(rng, uniforms.data(), uniforms.size());
+
+        std::vector<Organism> &selected = workspace.selected;
+        selected.clear();
+        for (size_t i = 0; i < count; i++) {
+            double uniform = uniforms[i];
 
             size_t index = std::upper_bound(intervals.begin(), intervals.end(), uniform) - intervals.begin();
+            // The last interval may end slightly before 1 because of rounding errors.
+            index = std::min(index, organisms.size() - 1);
 
             selected.push_back(organisms[index]);
-            if (verbose) {
-                std::cout << "u = " << uniform << " we choose the organism " << index + 1 << std::endl;
+            if constexpr (Trace::enabled) {
+                *output << "u = " << uniform << " we choose the organism " << index + 1 << std::endl;
             }
         }
 
-        if (verbose) {
-            std::cout << std::endl;
+        if constexpr (Trace::enabled) {
+            *output << std::endl;
+        }
+    }
+
+    template<typename Trace>
+    void Optimiser::tournament_selection(const std::vector<Organism> &organisms, size_t count) {
+        auto size = (uint32_t) organisms.size();
+
+        std::vector<Organism> &selected = workspace.selected;
+        selected.clear();
+        for (size_t i = 0; i < count; i++) {
+            size_t a = bounded(rng, size);
+            size_t b = bounded(rng, size);
+            size_t index = better(b, a) ? b : a;
+
+            selected.push_back(organisms[index]);
+            if constexpr (Trace::enabled) {
+                *output << "Organism " << a + 1 << " against organism " << b + 1 << ", we choose the organism "
+                          << index + 1 << std::endl;
+            }
         }
 
-        return selected;
+        if constexpr (Trace::enabled) {
+            *output << std::endl;
+        }
     }
 
     void Optimiser::show_population(const std::vector<Organism> &population) const {
         size_t index = 1;
         for (const Organism &organism: population) {
-            std::cout << index << ": " << organism << " ";
-            std::cout << "x = " << to_domain(organism) << " ";
-            std::cout << "f = " << fitness(organism) << std::endl;
+            double x = to_domain(organism);
+            *output << index << ": " << organism << " ";
+            *output << "x = " << x << " ";
+            if (constraints.failed_predicates(x) != 0) {
+                // Do not evaluate the function outside the feasible region.
+                *output << "infeasible" << std::endl;
+            } else {
+                // Showing an organism is not an evaluation, so it is not counted.
+                *output << "f = " << f(x) << std::endl;
+            }
             index++;
         }
-        std::cout << std::endl;
+        *output << std::endl;
     }
 
-    Organism Optimiser::fittest(const std::vector<Organism> &organisms) const {
-        double best = 0;
-        Organism to_return = organisms[0];
-        for (const Organism &o: organisms) {
-            double ft = fitness(o);
-            if (ft > best) {
-                to_return = o;
-                best = ft;
+    size_t Optimiser::fittest() const {
+        size_t to_return = 0;
+        for (size_t i = 1; i < workspace.fitness_score.size(); i++) {
+            if (better(i, to_return)) {
+                to_return = i;
             }
         }
         return to_return;
     }
 
-    double Optimiser::maximum_fitness(const std::vector<Organism> &organisms) const {
+    double Optimiser::maximum_fitness() const {
         double best = 0;
-        for (const Organism &o: organisms) {
-            best = std::max(best, fitness(o));
+        for (double ft: workspace.fitness_score) {
+            best = std::max(best, ft);
         }
         return best;
     }
 
-    double Optimiser::average_fitness(const std::vector<Organism> &organisms) const {
+    double Optimiser::average_fitness() const {
         double sum = 0;
+        for (double ft: workspace.fitness_score) {
+            sum += ft;
+        }
+        return sum / (double) workspace.fitness_score.size();
+    }
+
+    double Optimiser::diversity(const std::vector<Organism> &organisms) const {
+        if (organisms.empty()) {
+            return 0;
+        }
+
+        // Count how many organisms have each gene set.
+        unsigned int counts[64] = {0};
         for (const Organism &o: organisms) {
-            sum += fitness(o);
+            bitvector chromosome = o.get_chromosome();
+            for (unsigned int gene = 0; gene < bits_per_chromosome; gene++) {
+                counts[gene] += (chromosome >> gene) & 1;
+            }
+        }
+
+        double sum = 0;
+        for (unsigned int gene = 0; gene < bits_per_chromosome; gene++) {
+            double p = (double) counts[gene] / (double) organisms.size();
+            sum += 4 * p * (1 - p);
         }
-        return sum / (double) organisms.size();
+        return sum / bits_per_chromosome;
     }
 
-    std::vector<Organism> Optimiser::cross_over(const std::vector<Organism> &organisms, bool verbose) const {
-        // Indices of organisms that will be crossed-over.
-        std::vector<size_t> cross;
+    void Optimiser::adapt(unsigned int epoch, const std::vector<Organism> &organisms) {
+        if (!record_telemetry && !rate_controller) {
+            return;
+        }
+        epoch_stats stats{epoch, evaluations, maximum_fitness(), average_fitness(), diversity(organisms),
+                          cross_probability, mutation_probability};
+
+        if (rate_controller) {
+            rate_controller->update(stats, cross_probability, mutation_probability);
+            // Record the rates that will actually be used to create the next population.
+            stats.cross_probability = cross_probability;
+            stats.mutation_probability = mutation_probability;
+        }
+        if (record_telemetry) {
+            telemetry.push_back(stats);
+        }
+    }
 
-        // The next population.
-        std::vector<Organism> next = organisms;
+    template<typename Trace>
+    void Optimiser::cross_over(std::vector<Organism> &organisms) {
+        // Indices of organisms that will be crossed-over.
+        std::vector<size_t> &cross = workspace.cross;
+        cross.clear();
 
-        // We need to generate split points.
-        std::uniform_int_distribution<std::mt19937::result_type> distribution(0, bits_per_chromosome - 1);
+        // The organisms are crossed-over in place.
+        std::vector<Organism> &next = organisms;
 
-        if (verbose) {
-            std::cout << "Cross probability: " << cross_probability << std::endl;
+        if constexpr (Trace::enabled) {
+            *output << "Cross probability: " << cross_probability << std::endl;
         }
 
+        // Generate a uniform number in [0,1) for every organism.
+        std::vector<double> &uniforms = workspace.uniforms;
+        uniforms.resize(organisms.size());
+        fill_uniform(rng, uniforms.data(), uniforms.size());
+
         // Select organisms to be crossed over.
         for (size_t index = 0; index < organisms.size(); index++) {
-            // Generate a uniform number in [0,1)
-            std::uniform_real_distribution<> dist(0, 1);
-            double uniform = dist(rng);
+            double uniform = uniforms[index];
 
-            if (verbose) {
-                std::cout << index + 1 << ": " << organisms[index] << " u= " << uniform;
+            if constexpr (Trace::enabled) {
+                *output << index + 1 << ": " << organisms[index] << " u= " << uniform;
             }
 
             if (uniform < cross_probability) {
-                if (verbose) {
-                    std::cout << " * selected";
+                if constexpr (Trace::enabled) {
+                    *output << " * selected";
                 }
                 cross.push_back(index);
             }
 
-            if (verbose) {
-                std::cout << std::endl;
+            if constexpr (Trace::enabled) {
+                *output << std::endl;
             }
         }
 
-        if (verbose) {
-            std::cout << std::endl;
+        if constexpr (Trace::enabled) {
+            *output << std::endl;
         }
 
         // Apply the cross-over operation.
         size_t index = 0;
         while (index < cross.size() && index + 1 < cross.size()) {
             // Generate a random split point between 0 and bits_per_chromosome-1.
-            unsigned int split_point = distribution(rng);
+            unsigned int split_point = bounded(rng, bits_per_chromosome);
 
-            if (verbose) {
-                std::cout << "Combining chromosome " << cross[index] + 1 << " with chromosome " << cross[index + 1] + 1
+            if constexpr (Trace::enabled) {
+                *output << "Combining chromosome " << cross[index] + 1 << " with chromosome " << cross[index + 1] + 1
                           << std::endl;
-                std::cout << next[cross[index]] << " " << next[cross[index + 1]] << " ";
-                std::cout << "split point: " << split_point << std::endl;
+                *output << next[cross[index]] << " " << next[cross[index + 1]] << " ";
+                *output << "split point: " << split_point << std::endl;
             }
 
             next[cross[index]].cross(next[cross[index + 1]], split_point);
-            if (verbose) {
-                std::cout << "Result: ";
-                std::cout << next[cross[index]] << " " << next[cross[index + 1]] << std::endl;
+            if constexpr (Trace::enabled) {
+                *output << "Result: ";
+                *output << next[cross[index]] << " " << next[cross[index + 1]] << std::endl;
             }
             index += 2;
         }
@@ -201,149 +383,521 @@ namespace GeneticSimulation {
         // There might be one more chromosome without a pair.
         if (index < cross.size()) {
             // Pair it with the first one.
-            unsigned int split_point = distribution(rng);
+            unsigned int split_point = bounded(rng, bits_per_chromosome);
 
-            if (verbose) {
-                std::cout << "Combining chromosome " << cross[index] + 1 << " with chromosome " << cross[0] + 1
+            if constexpr (Trace::enabled) {
+                *output << "Combining chromosome " << cross[index] + 1 << " with chromosome " << cross[0] + 1
                           << std::endl;
-                std::cout << next[cross[index]] << " " << next[cross[0]] << " ";
-                std::cout << "split point: " << split_point << std::endl;
+                *output << next[cross[index]] << " " << next[cross[0]] << " ";
+                *output << "split point: " << split_point << std::endl;
             }
 
             next[cross[index]].cross(next[cross[0]], split_point);
 
-            if (verbose) {
-                std::cout << "Result: ";
-                std::cout << next[cross[index]] << " " << next[cross[0]] << std::endl << std::endl;
+            if constexpr (Trace::enabled) {
+                *output << "Result: ";
+                *output << next[cross[index]] << " " << next[cross[0]] << std::endl << std::endl;
             }
 
         }
-        return next;
     }
 
-    std::vector<Organism> Optimiser::mutation(const std::vector<Organism> &organisms, bool verbose) const {
-        // We need to generate random uniform numbers in [0,1)
-        std::uniform_real_distribution<> real_dist(0, 1);
-
-        // We also need to generate integers between 0 and bits_per_chromosome-1 so that we can
-        // flip random genes.
-        std::uniform_int_distribution<std::mt19937::result_type> int_dist(0, bits_per_chromosome - 1);
-
-        std::vector<Organism> mutated = organisms;
+    template<typename Trace>
+    void Optimiser::mutation(std::vector<Organism> &organisms) {
+        // The organisms are mutated in place.
+        std::vector<Organism> &mutated = organisms;
 
         // Indices of organisms to be mutated.
-        std::vector<size_t> to_mutate;
+        std::vector<size_t> &to_mutate = workspace.to_mutate;
+        to_mutate.clear();
 
-        if (verbose) {
-            std::cout << "Probability of mutation: " << mutation_probability << std::endl;
+        if constexpr (Trace::enabled) {
+            *output << "Probability of mutation: " << mutation_probability << std::endl;
         }
 
+        // We need to generate random uniform numbers in [0,1)
+        std::vector<double> &uniforms = workspace.uniforms;
+        uniforms.resize(organisms.size());
+        fill_uniform(rng, uniforms.data(), uniforms.size());
+
         // Find organisms to be mutated.
         for (size_t i = 0; i < mutated.size(); i++) {
-            double uniform = real_dist(rng);
-            if (verbose) {
-                std::cout << i + 1 << ": " << organisms[i] << " u = " << uniform << " ";
+            double uniform = uniforms[i];
+            if constexpr (Trace::enabled) {
+                *output << i + 1 << ": " << organisms[i] << " u = " << uniform << " ";
             }
             if (uniform < mutation_probability) {
                 // Select this organism to be mutated.
-                if (verbose) {
-                    std::cout << "* selected";
+                if constexpr (Trace::enabled) {
+                    *output << "* selected";
                 }
                 to_mutate.push_back(i);
             }
-            if (verbose) {
-                std::cout << std::endl;
+            if constexpr (Trace::enabled) {
+                *output << std::endl;
             }
         }
-        if (verbose) {
-            std::cout << std::endl;
+        if constexpr (Trace::enabled) {
+            *output << std::endl;
         }
 
         for (size_t index: to_mutate) {
-            unsigned gene = int_dist(rng);
-            if (verbose) {
-                std::cout << "Mutating organism " << index + 1 << ", gene " << gene << std::endl;
-                std::cout << "Before: " << organisms[index] << ", ";
+            // Flip a random gene between 0 and bits_per_chromosome-1.
+            unsigned gene = bounded(rng, bits_per_chromosome);
+            if constexpr (Trace::enabled) {
+                *output << "Mutating organism " << index + 1 << ", gene " << gene << std::endl;
+                *output << "Before: " << mutated[index] << ", ";
             }
             mutated[index].mutate(gene);
-            if (verbose) {
-                std::cout << "after: " << mutated[index] << std::endl;
+            if constexpr (Trace::enabled) {
+                *output << "after: " << mutated[index] << std::endl;
             }
         }
-        if (verbose) {
-            std::cout << std::endl;
+        if constexpr (Trace::enabled) {
+            *output << std::endl;
         }
-        return mutated;
     }
 
 
-    std::vector<Organism> Optimiser::next_generation(const std::vector<Organism> &organisms, bool verbose) const {
-        if (organisms.empty()) {
-            return organisms;
+    template<typename Trace>
+    void Optimiser::refine(std::vector<Organism> &organisms) {
+        if (memetic_top_k == 0 || generation % memetic_interval != 0) {
+            return;
         }
-        if (verbose) {
-            show_population(organisms);
+
+        // Find the fittest organisms without sorting the whole population.
+        std::vector<size_t> &ranking = workspace.ranking;
+        ranking.clear();
+        for (size_t i = 0; i < organisms.size(); i++) {
+            ranking.push_back(i);
+        }
+        size_t k = std::min<size_t>(memetic_top_k, organisms.size());
+        top_k(ranking, k, [this](size_t a, size_t b) {
+            return better(a, b);
+        });
+
+        std::function<double(const Organism &)> evaluate = [this](const Organism &o) {
+            if (constraints.empty()) {
+                return fitness(o);
+            }
+            // Do not let the local search leave the feasible region.
+            double x = to_domain(o);
+            if (constraints.failed_predicates(x) != 0) {
+                saved_evaluations++;
+                return -std::numeric_limits<double>::infinity();
+            }
+            return fitness(o) - constraints.penalty(x);
+        };
+        for (size_t i = 0; i < k; i++) {
+            size_t index = ranking[i];
+            if constexpr (Trace::enabled) {
+                *output << "Refining organism " << index + 1 << ": " << organisms[index] << " -> ";
+            }
+            workspace.fitness_score[index] = hill_climb(organisms[index], workspace.fitness_score[index], evaluate,
+                                                        memetic_passes);
+            if (!constraints.empty()) {
+                // The search may have moved an infeasible organism into the feasible region.
+                workspace.violation[index] = constraints.failed_predicates(to_domain(organisms[index]));
+            }
+            if constexpr (Trace::enabled) {
+                *output << organisms[index] << std::endl;
+            }
+        }
+        if constexpr (Trace::enabled) {
+            *output << std::endl;
+        }
+    }
+
+    void Optimiser::keep_elites(const std::vector<Organism> &organisms, size_t k) {
+        std::vector<Organism> &elites = workspace.elites;
+        elites.clear();
+        if (k == 1) {
+            // A single scan finds the fittest organism.
+            elites.push_back(organisms[fittest()]);
+            return;
         }
-        // Find the fittest organism, so that it is passed in the next generation.
-        Organism best = fittest(organisms);
-        std::vector<Organism> selected = selection(organisms, verbose);
 
+        // Find the fittest organisms without sorting the whole population.
+        std::vector<size_t> &ranking = workspace.ranking;
+        ranking.clear();
+        for (size_t i = 0; i < organisms.size(); i++) {
+            ranking.push_back(i);
+        }
+        top_k(ranking, k, [this](size_t a, size_t b) {
+            return better(a, b);
+        });
+        for (size_t i = 0; i < k; i++) {
+            elites.push_back(organisms[ranking[i]]);
+        }
+    }
 
-        if (verbose) {
-            std::cout << "After selection: " << std::endl;
+    template<typename Trace>
+    void Optimiser::breed(const std::vector<Organism> &organisms, size_t count) {
+        if (constraints.empty()) {
+            selection<Trace>(organisms, count);
+        } else {
+            tournament_selection<Trace>(organisms, count);
+        }
+        std::vector<Organism> &selected = workspace.selected;
+
+        if constexpr (Trace::enabled) {
+            *output << "After selection: " << std::endl;
             show_population(selected);
         }
-        std::vector<Organism> crossed = cross_over(selected, verbose);
+        cross_over<Trace>(selected);
 
-        if (verbose) {
-            std::cout << "After crossing over: " << std::endl;
-            show_population(crossed);
+        if constexpr (Trace::enabled) {
+            *output << "After crossing over: " << std::endl;
+            show_population(selected);
         }
 
-        std::vector<Organism> mutated = mutation(crossed, verbose);
+        mutation<Trace>(selected);
 
-        if (verbose) {
-            std::cout << "After mutation: " << std::endl;
-            show_population(mutated);
+        if constexpr (Trace::enabled) {
+            *output << "After mutation: " << std::endl;
+            show_population(selected);
         }
+    }
 
-        // Add the fittest organism to the next generation.
-        mutated.push_back(best);
+    template<typename Trace>
+    void Optimiser::truncate(std::vector<Organism> &organisms) {
+        size_t mu = organisms.size();
+        std::vector<Organism> &offspring = workspace.selected;
+        // The scores of the offspring follow the scores of the parents.
+        evaluate(offspring, true);
+
+        std::vector<Organism> &pool = workspace.pool;
+        pool.clear();
+        pool.insert(pool.end(), organisms.begin(), organisms.end());
+        pool.insert(pool.end(), offspring.begin(), offspring.end());
+
+        // With the comma strategy, only the offspring compete.
+        size_t first = replacement.get_strategy() == Replacement::Strategy::comma ? mu : 0;
+        std::vector<size_t> &ranking = workspace.ranking;
+        ranking.clear();
+        for (size_t i = first; i < pool.size(); i++) {
+            ranking.push_back(i);
+        }
+        top_k(ranking, mu, [this](size_t a, size_t b) {
+            return better(a, b);
+        });
+
+        organisms.clear();
+        workspace.next_fitness.clear();
+        workspace.next_violation.clear();
+        for (size_t i = 0; i < mu && i < ranking.size(); i++) {
+            size_t index = ranking[i];
+            organisms.push_back(pool[index]);
+            workspace.next_fitness.push_back(workspace.fitness_score[index]);
+            if (!constraints.empty()) {
+                workspace.next_violation.push_back(workspace.violation[index]);
+            }
+            if constexpr (Trace::enabled) {
+                *output << "Organism " << index + 1 << (index < mu ? " (parent)" : " (offspring)") << " survives"
+                          << std::endl;
+            }
+        }
+        std::swap(workspace.fitness_score, workspace.next_fitness);
+        std::swap(workspace.violation, workspace.next_violation);
+        workspace.fitness_current = true;
+    }
 
-        if (verbose) {
-            std::cout << "Final population: " << std::endl;
-            show_population(mutated);
+    template<typename Trace>
+    void Optimiser::replace_oldest(std::vector<Organism> &organisms) {
+        size_t n = organisms.size();
+        std::vector<unsigned int> &age = workspace.age;
+        if (age.size() != n) {
+            // This is a new population.
+            age.assign(n, 0);
+        }
+        size_t best = fittest();
+
+        std::vector<Organism> &offspring = workspace.selected;
+        // The scores of the offspring follow the scores of the parents.
+        evaluate(offspring, true);
+
+        // Find the oldest organisms, without the fittest one. Among organisms of the same age, the less fit
+        // are replaced first.
+        std::vector<size_t> &ranking = workspace.ranking;
+        ranking.clear();
+        for (size_t i = 0; i < n; i++) {
+            if (i != best) {
+                ranking.push_back(i);
+            }
         }
+        top_k(ranking, offspring.size(), [this, &age](size_t a, size_t b) {
+            if (age[a] != age[b]) {
+                return age[a] > age[b];
+            }
+            return better(b, a);
+        });
 
+        for (unsigned int &a: age) {
+            a++;
+        }
+        for (size_t i = 0; i < offspring.size(); i++) {
+            size_t index = ranking[i];
+            if constexpr (Trace::enabled) {
+                *output << "Organism " << index + 1 << " (age " << age[index] << ") is replaced" << std::endl;
+            }
+            organisms[index] = offspring[i];
+            workspace.fitness_score[index] = workspace.fitness_score[n + i];
+            if (!constraints.empty()) {
+                workspace.violation[index] = workspace.violation[n + i];
+            }
+            age[index] = 0;
+        }
+        workspace.fitness_score.resize(n);
+        if (!constraints.empty()) {
+            workspace.violation.resize(n);
+        }
+        workspace.fitness_current = true;
+    }
+
+    void Optimiser::share_fitness(const std::vector<Organism> &organisms) {
+        std::vector<double> &positions = workspace.positions;
+        positions.clear();
+        for (const Organism &o: organisms) {
+            positions.push_back(to_domain(o));
+        }
+        workspace.raw_fitness.assign(workspace.fitness_score.begin(), workspace.fitness_score.end());
+
+        if (niching.get_strategy() == Niching::Strategy::sharing) {
+            GeneticSimulation::share_fitness(positions, workspace.fitness_score, niching.get_radius(),
+                                             niching.get_alpha(), workspace.order, workspace.prefix);
+            return;
+        }
+
+        // Clearing: only the winner of every niche keeps its fitness.
+        niche_winners(positions, workspace.raw_fitness, niching.get_radius(), workspace.winners, workspace.order,
+                      workspace.position, workspace.cleared);
+        std::fill(workspace.fitness_score.begin(), workspace.fitness_score.end(), 0);
+        for (size_t winner: workspace.winners) {
+            workspace.fitness_score[winner] = workspace.raw_fitness[winner];
+        }
+    }
 
-        return mutated;
+    void Optimiser::restore_fitness() {
+        std::swap(workspace.fitness_score, workspace.raw_fitness);
+    }
+
+    template<typename Trace>
+    void Optimiser::crowd(std::vector<Organism> &organisms) {
+        size_t n = organisms.size();
+
+        // Pair the parents at random, by shuffling their indices.
+        std::vector<size_t> &parents = workspace.ranking;
+        parents.clear();
+        for (size_t i = 0; i < n; i++) {
+            parents.push_back(i);
+        }
+        for (size_t i = n - 1; i > 0; i--) {
+            std::swap(parents[i], parents[bounded(rng, (uint32_t) i + 1)]);
+        }
+
+        // The children of the pair 2k, 2k + 1 are the organisms 2k, 2k + 1 of the selected buffer.
+        size_t pairs = n / 2;
+        std::vector<Organism> &children = workspace.selected;
+        children.clear();
+        for (size_t i = 0; i < 2 * pairs; i++) {
+            children.push_back(organisms[parents[i]]);
+        }
+
+        std::vector<double> &uniforms = workspace.uniforms;
+        uniforms.resize(pairs);
+        fill_uniform(rng, uniforms.data(), uniforms.size());
+        for (size_t k = 0; k < pairs; k++) {
+            if (uniforms[k] < cross_probability) {
+                children[2 * k].cross(children[2 * k + 1], bounded(rng, bits_per_chromosome));
+            }
+        }
+        mutation<Trace>(children);
+
+        // The scores of the children follow the scores of the parents.
+        evaluate(children, true);
+
+        for (size_t k = 0; k < pairs; k++) {
+            size_t a = parents[2 * k], b = parents[2 * k + 1];
+            size_t c = n + 2 * k, d = n + 2 * k + 1;
+            double xa = to_domain(organisms[a]), xb = to_domain(organisms[b]);
+            double xc = to_domain(children[2 * k]), xd = to_domain(children[2 * k + 1]);
+            // Every child competes with the closest parent.
+            if (std::abs(xa - xd) + std::abs(xb - xc) < std::abs(xa - xc) + std::abs(xb - xd)) {
+                std::swap(c, d);
+            }
+            for (auto [parent, child]: {std::pair(a, c), std::pair(b, d)}) {
+                if (!better(child, parent)) {
+                    continue;
+                }
+                if constexpr (Trace::enabled) {
+                    *output << "Organism " << parent + 1 << " is replaced by its child " << children[child - n]
+                              << std::endl;
+                }
+                organisms[parent] = children[child - n];
+                workspace.fitness_score[parent] = workspace.fitness_score[child];
+                if (!constraints.empty()) {
+                    workspace.violation[parent] = workspace.violation[child];
+                }
+            }
+        }
+        workspace.fitness_score.resize(n);
+        if (!constraints.empty()) {
+            workspace.violation.resize(n);
+        }
+        workspace.fitness_current = true;
+    }
+
+    void Optimiser::find_optima(const std::vector<Organism> &organisms) {
+        optima.clear();
+        if (organisms.empty()) {
+            return;
+        }
+        if (niching.get_strategy() == Niching::Strategy::none) {
+            optima.push_back(to_domain(organisms[fittest()]));
+            return;
+        }
+
+        std::vector<double> &positions = workspace.positions;
+        positions.clear();
+        for (const Organism &o: organisms) {
+            positions.push_back(to_domain(o));
+        }
+        niche_winners(positions, workspace.fitness_score, niching.get_radius(), workspace.winners, workspace.order,
+                      workspace.position, workspace.cleared);
+        for (size_t winner: workspace.winners) {
+            if (constraints.empty() || workspace.violation[winner] == 0) {
+                optima.push_back(positions[winner]);
+            }
+        }
+    }
+
+    template<typename Trace>
+    void Optimiser::next_generation(std::vector<Organism> &organisms) {
+        if (organisms.empty()) {
+            return;
+        }
+        if constexpr (Trace::enabled) {
+            show_population(organisms);
+        }
+        refine<Trace>(organisms);
+        generation++;
+
+        if (niching.get_strategy() == Niching::Strategy::crowding) {
+            crowd<Trace>(organisms);
+            if constexpr (Trace::enabled) {
+                *output << "Final population: " << std::endl;
+                show_population(organisms);
+            }
+            return;
+        }
+
+        // Find the fittest organisms, so that they are passed in the next generation.
+        keep_elites(organisms, replacement.elites(organisms.size()));
+
+        // Sharing and clearing only change the fitness scores seen by the selection.
+        bool shared = niching.get_strategy() != Niching::Strategy::none;
+        if (shared) {
+            share_fitness(organisms);
+        }
+        breed<Trace>(organisms, replacement.offspring(organisms.size()));
+        if (shared) {
+            restore_fitness();
+        }
+        std::vector<Organism> &selected = workspace.selected;
+
+        switch (replacement.get_strategy()) {
+            case Replacement::Strategy::generational:
+                // Add the fittest organisms to the next generation.
+                selected.insert(selected.end(), workspace.elites.begin(), workspace.elites.end());
+                // The selected buffer becomes the next population, and the old population's memory is reused
+                // by the next epoch.
+                std::swap(organisms, selected);
+                break;
+            case Replacement::Strategy::plus:
+            case Replacement::Strategy::comma:
+                truncate<Trace>(organisms);
+                break;
+            case Replacement::Strategy::age:
+                replace_oldest<Trace>(organisms);
+                break;
+        }
+
+        if constexpr (Trace::enabled) {
+            *output << "Final population: " << std::endl;
+            show_population(organisms);
+        }
+    }
+
+    void Optimiser::evolve(std::vector<Organism> &population) {
+        evaluate(population);
+        next_generation<NoTrace>(population);
     }
 
     double Optimiser::optimise(bool plot) {
+        // Points used to plot the function.
+        std::vector<double> fun_x;
+        std::vector<double> fun_y;
+
         if (plot) {
             // Initialize the window size.
             auto w = matplot::figure(true);
             w->size(800, 800);
-        }
 
-
-        // Points used to plot the function.
-        std::vector<double> fun_x = matplot::linspace(domain.left, domain.right, 2000);
-        std::vector<double> fun_y = matplot::transform(fun_x, f);
+            // Only sample the function when plotting, it may be expensive to evaluate.
+            fun_x = matplot::linspace(domain.left, domain.right, 2000);
+            fun_y = matplot::transform(fun_x, f);
+        }
 
         // These are used to plot the graph of the evolution of the average and the best fitness per iterations.
         std::vector<double> num_iter;
         std::vector<double> avg_fit;
         std::vector<double> max_fit;
 
+        if (record_telemetry) {
+            telemetry.clear();
+            telemetry.reserve(epochs);
+        }
+
+        if (record_run) {
+            // Seed the generator before the initial population is drawn, so that the run can be replayed.
+            rng.seed(recording.seed);
+            recording.epochs.clear();
+        }
+
+        evaluations = 0;
+        saved_evaluations = 0;
+        repairs = 0;
+
+        // Start from the configured rates, not from the rates the controller reached in the last run.
+        cross_probability = configured_cross_probability;
+        mutation_probability = configured_mutation_probability;
+        if (rate_controller) {
+            rate_controller->reset();
+        }
+
         std::vector<Organism> population = initial_population();
-        std::cout << "Initial population: " << std::endl;
+        generation = 0;
+        workspace.fitness_current = false;
+        workspace.age.clear();
+        *output << "Initial population: " << std::endl;
 
         double best = 0;
 
         for (unsigned int e = 0; e < epochs; e++) {
-            double max_fitness = maximum_fitness(population);
-            double avg_fitness = average_fitness(population);
+            evaluate(population);
+            double max_fitness = maximum_fitness();
+            double avg_fitness = average_fitness();
+            adapt(e, population);
+            if (record_run) {
+                recording.epochs.push_back({e, population_digest(population), evaluations, max_fitness, avg_fitness});
+            }
+
+            if (max_fitness >= target_fitness) {
+                *output << "Target fitness reached after " << evaluations << " evaluations" << std::endl;
+                // The population is already scored, so the final evaluation reuses the scores.
+                workspace.fitness_current = true;
+                break;
+            }
 
             if (plot) {
                 // Add the current iteration to the points, paired with the best fitness and the
@@ -356,17 +910,17 @@ namespace GeneticSimulation {
 
             // Check if the best has changed.
             if (max_fitness > best) {
-                std::cout << "Max fitness: " << std::fixed << std::setprecision(10) << max_fitness << std::endl;
-                std::cout << "Average fitness: " << std::fixed << std::setprecision(10) << avg_fitness << std::endl;
+                *output << "Max fitness: " << std::fixed << std::setprecision(10) << max_fitness << std::endl;
+                *output << "Average fitness: " << std::fixed << std::setprecision(10) << avg_fitness << std::endl;
                 best = max_fitness;
 
                 // Plot the organisms on the graph as a scatter.
                 if (plot) {
                     std::vector<double> points;
                     std::vector<double> fit;
-                    for (const Organism &o: population) {
-                        points.push_back(to_domain(o));
-                        fit.push_back(fitness(o));
+                    for (size_t i = 0; i < population.size(); i++) {
+                        points.push_back(to_domain(population[i]));
+                        fit.push_back(workspace.fitness_score[i]);
                     }
                     // Plot the function.
                     auto function_plot = matplot::plot(fun_x, fun_y);
@@ -385,11 +939,11 @@ namespace GeneticSimulation {
 
             }
 
-            if (e == 0) {
-                // If the current epoch is the first one, enable verbose output.
-                population = next_generation(population, true);
+            if (e == 0 && output != discarded.get()) {
+                // If the current epoch is the first one, enable verbose output, unless nobody reads it.
+                next_generation<VerboseTrace>(population);
             } else {
-                population = next_generation(population, false);
+                next_generation<NoTrace>(population);
             }
         }
 
@@ -417,19 +971,105 @@ namespace GeneticSimulation {
             matplot::show();
         }
 
-        return to_domain(fittest(population));
+        evaluate(population);
+        find_optima(population);
+        return to_domain(population[fittest()]);
     }
 
     unsigned int Optimiser::get_bits_per_chromosome() const {
         return bits_per_chromosome;
     }
 
+    void Optimiser::set_rate_controller(std::unique_ptr<RateController> controller) {
+        rate_controller = std::move(controller);
+    }
+
+    void Optimiser::set_output(std::ostream *stream) {
+        if (stream == nullptr) {
+            // A stream without a buffer discards everything written to it.
+            discarded = std::make_unique<std::ostream>(nullptr);
+            stream = discarded.get();
+        }
+        output = stream;
+    }
+
+    void Optimiser::set_telemetry(bool enabled) {
+        record_telemetry = enabled;
+    }
+
+    const std::vector<epoch_stats> &Optimiser::get_telemetry() const {
+        return telemetry;
+    }
+
+    void Optimiser::set_recording(bool enabled, std::mt19937::result_type seed) {
+        record_run = enabled;
+        recording.seed = seed;
+        recording.epochs.clear();
+    }
+
+    const run_record &Optimiser::get_recording() const {
+        return recording;
+    }
+
+    unsigned long long Optimiser::get_evaluations() const {
+        return evaluations;
+    }
+
+    void Optimiser::set_memetic(unsigned int top_k, unsigned int interval, unsigned int max_passes) {
+        memetic_top_k = top_k;
+        memetic_interval = std::max(interval, 1u);
+        memetic_passes = max_passes;
+    }
+
+    void Optimiser::set_target_fitness(double target) {
+        target_fitness = target;
+    }
+
+    void Optimiser::set_batch_evaluator(batch_function evaluator) {
+        batch_evaluator = std::move(evaluator);
+    }
+
+    void Optimiser::set_constraints(Constraints _constraints) {
+        constraints = std::move(_constraints);
+    }
+
+    void Optimiser::set_replacement(Replacement _replacement) {
+        replacement = _replacement;
+        workspace.reserve(population_size + replacement.offspring(population_size));
+        workspace.fitness_current = false;
+        workspace.age.clear();
+    }
+
+    void Optimiser::set_niching(Niching _niching) {
+        niching = _niching;
+        workspace.fitness_current = false;
+    }
+
+    const std::vector<double> &Optimiser::get_optima() const {
+        return optima;
+    }
+
+    unsigned long long Optimiser::get_saved_evaluations() const {
+        return saved_evaluations;
+    }
+
+    unsigned long long Optimiser::get_repairs() const {
+        return repairs;
+    }
+
     double Optimiser::fitness(const GeneticSimulation::Organism &organism) const {
+        evaluations++;
         return f(to_domain(organism));
     }
 
     double Optimiser::to_domain(const GeneticSimulation::Organism &organism) const {
-        auto chr = (double) organism.get_chromosome();
-        return chr * step_size + domain.left;
+        return decode_chromosome(organism.get_chromosome(), domain, step_size);
+    }
+
+    Organism Optimiser::from_domain(double x) const {
+        bitvector maximum = ((bitvector) 1 << bits_per_chromosome) - 1;
+        double chr = std::round((x - domain.left) / step_size);
+        chr = std::clamp(chr, 0.0, (double) maximum);
+        return Organism((bitvector) chr, bits_per_chromosome);
     }
-}
\ No newline at end of file
+}
@@ -6,6 +6,9 @@
 #define GENETICSIMULATION_OPTIMISER_H
 
 #include<functional>
+#include<memory>
+#include<limits>
+#include<algorithm>
 #include<cmath>
 #include<vector>
 #include<iostream>
@@ -13,8 +16,23 @@
 #include<matplot/matplot.h>
 #include "organism.h"
 #include "defines.h"
+#include "workspace.h"
+#include "adaptive.h"
+#include "local_search.h"
+#include "constraints.h"
+#include "trace.h"
+#include "sampling.h"
+#include "replacement.h"
+#include "niching.h"
+#include "recording.h"
 
 namespace GeneticSimulation {
+    /*
+     * A function that evaluates a batch of points at once. It stores the value at every point in the second vector,
+     * in the same order.
+     */
+    typedef std::function<void(const std::vector<double> &, std::vector<double> &)> batch_function;
+
     /*
      * This class represents the optimiser of a given real function over a given range.
      */
@@ -25,6 +43,11 @@ namespace GeneticSimulation {
          */
         std::function<double(double)> f;
 
+        /*
+         * If it is set, it is used instead of f to evaluate whole populations.
+         */
+        batch_function batch_evaluator;
+
         /*
          * The size of the first generation.
          */
@@ -51,6 +74,13 @@ namespace GeneticSimulation {
          */
         double mutation_probability;
 
+        /*
+         * The probabilities given to the constructor. The rate controller changes the probabilities above during
+         * a run, and every run starts again from these.
+         */
+        double configured_cross_probability;
+        double configured_mutation_probability;
+
         /*
          * The number of epochs the optimiser will simulate.
          */
@@ -67,9 +97,90 @@ namespace GeneticSimulation {
         double step_size;
 
         /*
-         * Generates the initial population. It consists of randomly generated organisms.
+         * The scratch buffers borrowed by every stage of an epoch.
          */
-        std::vector<Organism> initial_population() const;
+        Workspace workspace;
+
+        /*
+         * The number of times the function was evaluated.
+         */
+        mutable unsigned long long evaluations;
+
+        /*
+         * Adjusts the cross-over and mutation probabilities between epochs. If it is null, the probabilities
+         * stay fixed for the whole run.
+         */
+        std::unique_ptr<RateController> rate_controller;
+
+        /*
+         * The stream the progress of a run is written to, and the stream that discards it, if the output is disabled.
+         */
+        std::ostream *output;
+        std::unique_ptr<std::ostream> discarded;
+
+        /*
+         * Whether the statistics of every epoch are recorded.
+         */
+        bool record_telemetry;
+
+        /*
+         * The statistics of every epoch of the last run, if telemetry is enabled.
+         */
+        std::vector<epoch_stats> telemetry;
+
+        /*
+         * Whether the runs are recorded, and the record of the last run. When recording, every run starts by seeding
+         * rng with the seed of the record.
+         */
+        bool record_run;
+        run_record recording;
+
+        /*
+         * The number of generations created since the start of the run.
+         */
+        unsigned int generation;
+
+        /*
+         * The memetic stage: every memetic_interval generations, the memetic_top_k fittest organisms are refined
+         * with a compass search over the decoded position (see local_search.h) of at most memetic_passes sweeps over
+         * the step sizes. It is disabled if memetic_top_k is 0.
+         */
+        unsigned int memetic_top_k;
+        unsigned int memetic_interval;
+        unsigned int memetic_passes;
+
+        /*
+         * The optimisation stops as soon as an organism reaches this fitness.
+         */
+        double target_fitness;
+
+        /*
+         * The constraints of the problem. If there are any, the selection is a feasibility-first tournament
+         * instead of the roulette wheel.
+         */
+        Constraints constraints;
+
+        /*
+         * The number of function evaluations avoided because an organism failed a feasibility check, and the number
+         * of organisms that were repaired.
+         */
+        unsigned long long saved_evaluations;
+        unsigned long long repairs;
+
+        /*
+         * How the next population is formed from the current one and its offspring.
+         */
+        Replacement replacement;
+
+        /*
+         * How the diversity of the population is preserved.
+         */
+        Niching niching;
+
+        /*
+         * The distinct optima found in the last run, in decreasing order of fitness.
+         */
+        std::vector<double> optima;
 
         /*
          * Prints information about the given population to stdout.
@@ -77,50 +188,164 @@ namespace GeneticSimulation {
         void show_population(const std::vector<Organism> &population) const;
 
         /*
-         * This method takes as a parameter a vector of organisms of size n and
-         * returns n-1 organisms based on each organism's probability of being selected.
+         * Computes the fitness score of every organism in the given population and stores it in the workspace.
+         * The other stages of the epoch read the fitness scores from there instead of recomputing them.
+         * If append is true, the scores are added after the scores already in the workspace. Otherwise, they
+         * replace them, unless they were already computed while the population was formed.
+         */
+        void evaluate(std::vector<Organism> &organisms, bool append = false);
+
+        /*
+         * Computes the fitness score of the given organism, taking the constraints into account. Infeasible organisms
+         * are repaired if possible. If the organism is still infeasible, the function is not evaluated: its fitness
+         * is 0 and the number of failed feasibility checks is stored in violation. Otherwise, violation is 0 and
+         * the penalties of the soft constraints are subtracted from the fitness.
+         */
+        double constrained_fitness(Organism &organism, double &violation);
+
+        /*
+         * Checks the feasibility predicates of the given organism, and repairs it if it is infeasible and
+         * a repair function was given. Returns the number of failed predicates after the repair.
+         */
+        unsigned int feasibility(Organism &organism);
+
+        /*
+         * Computes the fitness scores of the given population with the batch evaluator. Infeasible organisms
+         * are left out of the batch.
+         */
+        void evaluate_batch(std::vector<Organism> &organisms);
+
+        /*
+         * Returns true if the organism at index a is better than the organism at index b, in the last evaluated
+         * population. With constraints, feasible organisms are better than infeasible ones, and infeasible organisms
+         * are compared by how many feasibility checks they fail.
+         */
+        bool better(size_t a, size_t b) const;
+
+        /*
+         * The stages of an epoch are templates over the tracing level (see trace.h), so that the hot loop
+         * is compiled without any tracing code.
+         */
+
+        /*
+         * This method takes as a parameter a vector of organisms and
+         * selects count organisms based on each organism's probability of being selected.
          * The selection is implemented this way: we associate to each organism
          * a probability of being selected based on its fitness value. The more fit
          * it is, the higher the probability of being selected.
+         * The selected organisms are stored in the workspace.
+         */
+        template<typename Trace>
+        void selection(const std::vector<Organism> &organisms, size_t count);
+
+        /*
+         * This method selects count organisms from the given organisms with binary tournaments: two random organisms
+         * are drawn, and the better one is selected. It is used instead of the roulette wheel when the problem
+         * has constraints. The selected organisms are stored in the workspace.
+         */
+        template<typename Trace>
+        void tournament_selection(const std::vector<Organism> &organisms, size_t count);
+
+        /*
+         * This method takes a list of organisms and generates the next generation of organisms, in place.
+         * It applies the three transformations: selection, cross-over and mutation, and then forms the next
+         * generation according to the replacement strategy.
+         * The fitness scores of the organisms must already be computed.
+         */
+        template<typename Trace>
+        void next_generation(std::vector<Organism> &organisms);
+
+        /*
+         * Copies the k fittest organisms of the given population to the workspace.
+         */
+        void keep_elites(const std::vector<Organism> &organisms, size_t k);
+
+        /*
+         * This method creates count offspring of the given population, with selection, cross-over and mutation.
+         * The offspring are stored in the workspace.
+         */
+        template<typename Trace>
+        void breed(const std::vector<Organism> &organisms, size_t count);
+
+        /*
+         * The (mu + lambda) and (mu, lambda) replacements: evaluates the offspring in the workspace and replaces
+         * the given population with the fittest organisms among the population and the offspring, or among
+         * the offspring only.
+         */
+        template<typename Trace>
+        void truncate(std::vector<Organism> &organisms);
+
+        /*
+         * Applies fitness sharing or clearing to the fitness scores in the workspace, before the selection. The raw
+         * scores are kept in the workspace, and restore_fitness puts them back.
+         */
+        void share_fitness(const std::vector<Organism> &organisms);
+
+        void restore_fitness();
+
+        /*
+         * Replaces the given population with the next generation, with deterministic crowding.
          */
-        std::vector<Organism> selection(const std::vector<Organism> &organisms, bool verbose = false) const;
+        template<typename Trace>
+        void crowd(std::vector<Organism> &organisms);
 
         /*
-         * This method takes a list of organisms and generates the next generation of organisms.
-         * It applies the three transformations: selection, cross-over and mutation.
+         * Finds the distinct optima of the given population, whose fitness scores are in the workspace.
          */
-        std::vector<Organism> next_generation(const std::vector<Organism> &organisms, bool verbose = false) const;
+        void find_optima(const std::vector<Organism> &organisms);
 
         /*
-         * This method takes a list of organisms and applies the cross-over operation to some organisms
+         * The age-based replacement: evaluates the offspring in the workspace and replaces the oldest organisms of
+         * the given population with them, except for the fittest one.
+         */
+        template<typename Trace>
+        void replace_oldest(std::vector<Organism> &organisms);
+
+        /*
+         * This method takes a list of organisms and applies the cross-over operation, in place, to some organisms
          * in the list (selected based on the cross-over probability).
          */
-        std::vector<Organism> cross_over(const std::vector<Organism> &organisms, bool verbose = false) const;
+        template<typename Trace>
+        void cross_over(std::vector<Organism> &organisms);
 
         /*
-         * This method takes a list of organisms and applies the mutation operation to some organisms in
+         * This method takes a list of organisms and applies the mutation operation, in place, to some organisms in
          * the list (selected base on the mutation probability).
          * It works like this: each organism has the probability p of being mutated. If by chance we choose
          * on organism to be mutated, we will flip a random gene in the chromosome of the organism.
          */
-        std::vector<Organism> mutation(const std::vector<Organism> &organisms, bool verbose = false) const;
+        template<typename Trace>
+        void mutation(std::vector<Organism> &organisms);
+
+        /*
+         * This method applies the memetic stage to the given population, if it is enabled: the fittest organisms
+         * are improved with a local search, in place, and their fitness scores are updated.
+         */
+        template<typename Trace>
+        void refine(std::vector<Organism> &organisms);
 
 
         /*
-         * This method returns the fittest organism in the given vector. If the vector is empty
-         * the behaviour is undefined.
+         * This method returns the index of the fittest organism in the last evaluated population.
+         * If the population is empty the behaviour is undefined.
          */
-        Organism fittest(const std::vector<Organism> &organisms) const;
+        size_t fittest() const;
 
         /*
-         * This method returns the maximum fitness in the list of organisms.
+         * This method returns the maximum fitness in the last evaluated population.
          */
-        double maximum_fitness(const std::vector<Organism> &organisms) const;
+        double maximum_fitness() const;
 
         /*
-         * This method returns the average fitness in the list of organisms.
+         * This method returns the average fitness in the last evaluated population.
          */
-        double average_fitness(const std::vector<Organism> &organisms) const;
+        double average_fitness() const;
+
+        /*
+         * Gathers the statistics of the last evaluated population, records them if telemetry is enabled and
+         * lets the rate controller adjust the operator probabilities.
+         */
+        void adapt(unsigned int epoch, const std::vector<Organism> &organisms);
 
     public:
         Optimiser(std::function<double(double)> _function,
@@ -137,6 +362,110 @@ namespace GeneticSimulation {
          */
         double optimise(bool plot = false);
 
+        /*
+         * Generates the initial population. It consists of randomly generated organisms.
+         */
+        std::vector<Organism> initial_population() const;
+
+        /*
+         * Replaces the given population with the next generation. Once the workspace has warmed up,
+         * this method does not allocate memory.
+         * With the plus, comma and age replacements, the fitness scores computed while forming a generation are
+         * reused by the next call, so the population must not be changed between calls.
+         */
+        void evolve(std::vector<Organism> &population);
+
+        /*
+         * Sets the controller that adjusts the operator probabilities between epochs.
+         * Passing null keeps the probabilities fixed. The controller is reset at the start of every run.
+         */
+        void set_rate_controller(std::unique_ptr<RateController> controller);
+
+        /*
+         * Sets the stream the progress of a run is written to. It is std::cout by default, and null disables
+         * the output.
+         */
+        void set_output(std::ostream *stream);
+
+        /*
+         * Enables or disables recording the statistics of every epoch.
+         */
+        void set_telemetry(bool enabled);
+
+        /*
+         * Returns the statistics of every epoch of the last run. It is empty if telemetry is disabled.
+         */
+        const std::vector<epoch_stats> &get_telemetry() const;
+
+        /*
+         * Enables or disables recording the runs. When it is enabled, optimise seeds rng with the given seed,
+         * and records the digest of the population of every epoch.
+         */
+        void set_recording(bool enabled, std::mt19937::result_type seed = std::mt19937::default_seed);
+
+        /*
+         * Returns the record of the last run. It is empty if recording is disabled.
+         */
+        const run_record &get_recording() const;
+
+        /*
+         * Returns the number of times the function was evaluated in the last run.
+         */
+        unsigned long long get_evaluations() const;
+
+        /*
+         * Enables the memetic stage: every interval generations, the top_k fittest organisms are refined with
+         * a compass search over their decoded position, which halves its step from half the chromosome range down to
+         * one discrete interval. The search makes at most max_passes sweeps over the step sizes.
+         * Passing top_k = 0 disables it.
+         */
+        void set_memetic(unsigned int top_k, unsigned int interval = 1, unsigned int max_passes = 4);
+
+        /*
+         * Stops the optimisation as soon as an organism reaches the given fitness.
+         */
+        void set_target_fitness(double target);
+
+        /*
+         * Sets the function used to evaluate whole populations at once, for example a ProcessPool.
+         * Single evaluations (the local search, the verbose output and the plots) still use the function
+         * given to the constructor.
+         */
+        void set_batch_evaluator(batch_function evaluator);
+
+        /*
+         * Sets the constraints of the problem.
+         */
+        void set_constraints(Constraints _constraints);
+
+        /*
+         * Sets how the next population is formed from the current one and its offspring. By default, the fittest
+         * organism is kept and the offspring replace the rest of the population.
+         */
+        void set_replacement(Replacement _replacement);
+
+        /*
+         * Sets how the diversity of the population is preserved. By default, it is not.
+         */
+        void set_niching(Niching _niching);
+
+        /*
+         * Returns the distinct optima found in the last run, in decreasing order of fitness: the fittest organism of
+         * every niche of the final population. Without niching, it is only the best point found.
+         */
+        const std::vector<double> &get_optima() const;
+
+        /*
+         * Returns the number of function evaluations avoided in the last run because an organism failed
+         * a feasibility check.
+         */
+        unsigned long long get_saved_evaluations() const;
+
+        /*
+         * Returns the number of infeasible organisms that were repaired in the last run.
+         */
+        unsigned long long get_repairs() const;
+
         /*
          * Returns the number of bits needed to represent a chromosome.
          */
@@ -152,6 +481,17 @@ namespace GeneticSimulation {
          */
         double to_domain(const Organism &organism) const;
 
+        /*
+         * Converts the given number in the domain to the organism that encodes the closest discrete point.
+         */
+        Organism from_domain(double x) const;
+
+        /*
+         * This method returns the bit diversity of the given population: the average over all genes of 4p(1-p),
+         * where p is the fraction of organisms that have the gene set. It is 0 when all organisms are identical.
+         */
+        double diversity(const std::vector<Organism> &organisms) const;
+
     };
 }
 
@@ -33,27 +33,14 @@ namespace GeneticSimulation {
         if (i >= chromosome_size)
             return;
 
-        // Mask bits 0,1 ... i.
-        bitvector mask = (1ll << (i + 1)) - 1;
-        // Mask bits i+1, i+2 ... n
-        bitvector mask_n = ~mask;
-
-        bitvector a_prefix = chromosome & mask;
-        bitvector a_suffix = chromosome & mask_n;
-
-        bitvector b_prefix = other.chromosome & mask;
-        bitvector b_suffix = other.chromosome & mask_n;
-
-        chromosome = a_prefix | b_suffix;
-        other.set_chromosome(b_prefix | a_suffix);
+        cross_chromosomes(chromosome, other.chromosome, i);
     }
 
     void Organism::mutate(unsigned int i) {
         // It doesn't make sense for i to be more than chromosome_size-1.
         if (i >= chromosome_size)
             return;
-        bitvector bit = 1ll << i;
-        chromosome ^= bit;
+        flip_gene(chromosome, i);
     }
 
     Organism Organism::random_organism(unsigned int chromosome_size) {
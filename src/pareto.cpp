@@ -0,0 +1,178 @@
+//
+// Created by visan on 5/16/23.
+//
+
+#include "pareto.h"
+#include<algorithm>
+#include<iterator>
+#include<limits>
+
+namespace GeneticSimulation {
+    bool dominates(const objective_vector &a, const objective_vector &b, unsigned int num_objectives) {
+        bool better = false;
+        for (unsigned int i = 0; i < num_objectives; i++) {
+            if (a[i] < b[i]) {
+                return false;
+            }
+            if (a[i] > b[i]) {
+                better = true;
+            }
+        }
+        return better;
+    }
+
+    /*
+     * Returns true if a point of the given front dominates the given point. All points in the front come before
+     * the point in lexicographic order.
+     */
+    static bool front_dominates(const std::vector<objective_vector> &points, unsigned int num_objectives,
+                                const std::vector<size_t> &front, size_t point) {
+        if (num_objectives == 2) {
+            // The points of a front are sorted decreasingly by the first objective, so they are sorted increasingly
+            // by the second one. Only the last point can dominate, because it is the best in the second objective.
+            return dominates(points[front.back()], points[point], 2);
+        }
+        // The last points are the most similar to the given point, so they are the most likely to dominate it.
+        for (size_t i = front.size(); i-- > 0;) {
+            if (dominates(points[front[i]], points[point], num_objectives)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * With three objectives, every front keeps its staircase: the points of the front that are not dominated by
+     * another point of the front in the last two objectives, keyed by the second objective. They are sorted
+     * increasingly by the second objective, so they are sorted decreasingly by the third one.
+     * The points are added in lexicographic order, so every point of a front is at least as good as the given
+     * point in the first objective. A point of the front dominates the given point if and only if the first point of
+     * the staircase that is at least as good in the second objective is also at least as good in the third one,
+     * and is not equal to the given point. This takes O(log n) instead of a scan of the whole front.
+     */
+    static bool staircase_dominates(const std::vector<objective_vector> &points, const staircase &stairs,
+                                    size_t point) {
+        auto it = stairs.lower_bound(points[point][1]);
+        if (it == stairs.end()) {
+            return false;
+        }
+        const objective_vector &candidate = points[it->second];
+        return candidate[2] >= points[point][2] && dominates(candidate, points[point], 3);
+    }
+
+    /*
+     * Adds the given point to the staircase of its front, and removes the points it dominates in the last
+     * two objectives.
+     */
+    static void staircase_insert(const std::vector<objective_vector> &points, staircase &stairs, size_t point) {
+        double second = points[point][1], third = points[point][2];
+        auto it = stairs.lower_bound(second);
+        if (it != stairs.end() && points[it->second][2] >= third) {
+            // A point added before, which is at least as good in the first objective, covers this one.
+            return;
+        }
+        // The points that are at most as good in the second objective and in the third one come right before it.
+        if (it != stairs.end() && it->first == second) {
+            it = stairs.erase(it);
+        }
+        while (it != stairs.begin() && points[std::prev(it)->second][2] <= third) {
+            stairs.erase(std::prev(it));
+        }
+        stairs.emplace_hint(it, second, point);
+    }
+
+    void non_dominated_sort(const std::vector<objective_vector> &points, unsigned int num_objectives,
+                            std::vector<std::vector<size_t>> &fronts, std::vector<unsigned int> &rank,
+                            std::vector<size_t> &order, std::vector<staircase> &staircases) {
+        // Keep the memory of the fronts of the previous call.
+        for (std::vector<size_t> &front: fronts) {
+            front.clear();
+        }
+        size_t num_fronts = 0;
+        rank.assign(points.size(), 0);
+
+        // Sort the points decreasingly, in lexicographic order.
+        order.clear();
+        for (size_t i = 0; i < points.size(); i++) {
+            order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&points, num_objectives](size_t a, size_t b) {
+            for (unsigned int i = 0; i < num_objectives; i++) {
+                if (points[a][i] != points[b][i]) {
+                    return points[a][i] > points[b][i];
+                }
+            }
+            return a < b;
+        });
+
+        for (size_t point: order) {
+            // If a front dominates the point, then so do all the fronts before it, so we can binary search
+            // the first front that does not dominate the point.
+            size_t left = 0, right = num_fronts;
+            while (left < right) {
+                size_t middle = (left + right) / 2;
+                bool dominated = num_objectives == 3 ? staircase_dominates(points, staircases[middle], point)
+                                                     : front_dominates(points, num_objectives, fronts[middle], point);
+                if (dominated) {
+                    left = middle + 1;
+                } else {
+                    right = middle;
+                }
+            }
+
+            if (left == num_fronts) {
+                num_fronts++;
+                if (fronts.size() < num_fronts) {
+                    fronts.emplace_back();
+                }
+                if (num_objectives == 3) {
+                    if (staircases.size() < num_fronts) {
+                        staircases.emplace_back();
+                    }
+                    staircases[left].clear();
+                }
+            }
+            fronts[left].push_back(point);
+            rank[point] = left;
+            if (num_objectives == 3) {
+                staircase_insert(points, staircases[left], point);
+            }
+        }
+        fronts.resize(num_fronts);
+    }
+
+    void crowding_distance(const std::vector<objective_vector> &points, unsigned int num_objectives,
+                           const std::vector<size_t> &front, std::vector<double> &distance,
+                           std::vector<size_t> &sorted) {
+        const double infinity = std::numeric_limits<double>::infinity();
+        for (size_t point: front) {
+            distance[point] = 0;
+        }
+        if (front.size() <= 2) {
+            for (size_t point: front) {
+                distance[point] = infinity;
+            }
+            return;
+        }
+
+        sorted.assign(front.begin(), front.end());
+        for (unsigned int objective = 0; objective < num_objectives; objective++) {
+            std::sort(sorted.begin(), sorted.end(), [&points, objective](size_t a, size_t b) {
+                return points[a][objective] < points[b][objective];
+            });
+
+            double low = points[sorted.front()][objective];
+            double high = points[sorted.back()][objective];
+            distance[sorted.front()] = infinity;
+            distance[sorted.back()] = infinity;
+            if (high == low) {
+                continue;
+            }
+
+            for (size_t i = 1; i + 1 < sorted.size(); i++) {
+                distance[sorted[i]] += (points[sorted[i + 1]][objective] - points[sorted[i - 1]][objective]) /
+                                       (high - low);
+            }
+        }
+    }
+}
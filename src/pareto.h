@@ -0,0 +1,57 @@
+//
+// Created by visan on 5/16/23.
+//
+
+#ifndef GENETICSIMULATION_PARETO_H
+#define GENETICSIMULATION_PARETO_H
+
+#include<array>
+#include<cstddef>
+#include<map>
+#include<vector>
+
+namespace GeneticSimulation {
+    // The maximum number of objectives of a multi-objective problem.
+    constexpr unsigned int max_objectives = 3;
+
+    // The values of the objectives of a point. Only the first num_objectives values are used.
+    typedef std::array<double, max_objectives> objective_vector;
+
+    // The points of a front that are not dominated in the last two of three objectives, keyed by the second one.
+    typedef std::map<double, size_t> staircase;
+
+    /*
+     * Returns true if a dominates b, considering the first num_objectives objectives, which are maximised.
+     * That is, a is at least as good as b in every objective and strictly better in at least one.
+     */
+    bool dominates(const objective_vector &a, const objective_vector &b, unsigned int num_objectives);
+
+    /*
+     * Splits the given points into non-dominated fronts. The first front contains the points that are not dominated
+     * by any other point, the second front contains the points that are dominated only by points in the
+     * first front, and so on.
+     * It uses the efficient non-dominated sort with binary search: the points are sorted lexicographically, so a point
+     * can only be dominated by the ones before it, and each point is placed in the first front that does not
+     * dominate it. With two objectives, checking a front takes constant time, so the sort is O(n log n). With three
+     * objectives, every front keeps its points that are not dominated in the last two objectives in a search tree,
+     * so checking a front takes O(log n) and the sort is O(n log^2 n).
+     * The fronts are stored as lists of indices, and the rank of every point is the index of its front.
+     * The order and staircases buffers are scratch space, and the memory of all the buffers is reused. The nodes of
+     * the staircases are still allocated one by one, so the sort allocates with three objectives.
+     */
+    void non_dominated_sort(const std::vector<objective_vector> &points, unsigned int num_objectives,
+                            std::vector<std::vector<size_t>> &fronts, std::vector<unsigned int> &rank,
+                            std::vector<size_t> &order, std::vector<staircase> &staircases);
+
+    /*
+     * Computes the crowding distance of every point in the given front: the sum over all objectives of the
+     * normalised distance between the two neighbours of the point. The extreme points of the front get an
+     * infinite distance. The distances are written at the indices of the points.
+     * The sorted buffer is scratch space.
+     */
+    void crowding_distance(const std::vector<objective_vector> &points, unsigned int num_objectives,
+                           const std::vector<size_t> &front, std::vector<double> &distance,
+                           std::vector<size_t> &sorted);
+}
+
+#endif //GENETICSIMULATION_PARETO_H
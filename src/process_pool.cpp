@@ -0,0 +1,262 @@
+//
+// Created by visan on 5/18/23.
+//
+
+#include "process_pool.h"
+#include<algorithm>
+#include<cerrno>
+#include<poll.h>
+#include<signal.h>
+#include<stdexcept>
+#include<sys/socket.h>
+#include<sys/wait.h>
+#include<unistd.h>
+
+namespace GeneticSimulation {
+    /*
+     * Reads exactly size bytes from the given file descriptor. Returns false on error or end of file.
+     */
+    static bool read_all(int fd, void *data, size_t size) {
+        char *buffer = static_cast<char *>(data);
+        while (size > 0) {
+            ssize_t result = read(fd, buffer, size);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                return false;
+            }
+            buffer += result;
+            size -= result;
+        }
+        return true;
+    }
+
+    /*
+     * Writes exactly size bytes to the given file descriptor. Returns false on error.
+     * If the file descriptor is a socket, a closed peer is reported as an error instead of raising SIGPIPE.
+     */
+    static bool write_all(int fd, const void *data, size_t size, bool socket) {
+        const char *buffer = static_cast<const char *>(data);
+        while (size > 0) {
+            ssize_t result = socket ? send(fd, buffer, size, MSG_NOSIGNAL) : write(fd, buffer, size);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                return false;
+            }
+            buffer += result;
+            size -= result;
+        }
+        return true;
+    }
+
+    ProcessPool::ProcessPool(std::vector<std::string> _command, unsigned int num_workers, unsigned int _batch_size,
+                             unsigned int _max_retries) :
+            command(std::move(_command)),
+            batch_size(std::clamp(_batch_size, 1u, max_batch_size)),
+            max_retries(_max_retries),
+            workers(std::max(num_workers, 1u)),
+            restarts(0) {
+        try {
+            for (worker &w: workers) {
+                spawn(w);
+            }
+        } catch (...) {
+            // The destructor is not called, so stop the workers that were already started.
+            for (worker &w: workers) {
+                stop(w);
+            }
+            throw;
+        }
+    }
+
+    ProcessPool::~ProcessPool() {
+        for (worker &w: workers) {
+            stop(w);
+        }
+    }
+
+    void ProcessPool::spawn(worker &w) {
+        // Build the arguments before forking, the child must not allocate.
+        std::vector<char *> argv;
+        for (std::string &argument: command) {
+            argv.push_back(argument.data());
+        }
+        argv.push_back(nullptr);
+
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            throw std::runtime_error("Could not create the socket of a worker");
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            throw std::runtime_error("Could not start a worker");
+        }
+        if (pid == 0) {
+            // Connect the worker's end of the socket to its stdin and stdout.
+            dup2(fds[1], STDIN_FILENO);
+            dup2(fds[1], STDOUT_FILENO);
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+
+        close(fds[1]);
+        w.pid = pid;
+        w.socket = fds[0];
+        w.in_flight.clear();
+    }
+
+    void ProcessPool::stop(worker &w) {
+        if (w.socket >= 0) {
+            close(w.socket);
+            w.socket = -1;
+        }
+        if (w.pid > 0) {
+            kill(w.pid, SIGKILL);
+            waitpid(w.pid, nullptr, 0);
+            w.pid = -1;
+        }
+    }
+
+    void ProcessPool::restart_busy() {
+        for (worker &w: workers) {
+            if (!w.in_flight.empty()) {
+                w.in_flight.clear();
+                stop(w);
+                spawn(w);
+                restarts++;
+            }
+        }
+    }
+
+    void ProcessPool::evaluate(const std::vector<double> &points, std::vector<double> &values) {
+        values.resize(points.size());
+        size_t num_batches = (points.size() + batch_size - 1) / batch_size;
+
+        // The batches that were not sent yet, and how many times every batch was sent.
+        std::deque<size_t> pending;
+        std::vector<unsigned int> attempts(num_batches, 0);
+        for (size_t b = 0; b < num_batches; b++) {
+            pending.push_back(b);
+        }
+
+        auto batch_length = [&](size_t b) -> uint32_t {
+            return std::min<size_t>(batch_size, points.size() - b * batch_size);
+        };
+
+        // Restarts a worker that crashed, and puts its batches back at the front of the queue.
+        auto fail = [&](worker &w) {
+            for (auto it = w.in_flight.rbegin(); it != w.in_flight.rend(); it++) {
+                if (attempts[*it] > max_retries) {
+                    throw std::runtime_error("A batch failed too many times");
+                }
+                pending.push_front(*it);
+            }
+            stop(w);
+            spawn(w);
+            restarts++;
+        };
+
+        // Sends batches to the worker until it has two in flight.
+        auto fill = [&](worker &w) {
+            while (w.in_flight.size() < 2 && !pending.empty()) {
+                size_t b = pending.front();
+                pending.pop_front();
+                attempts[b]++;
+                w.in_flight.push_back(b);
+
+                uint32_t count = batch_length(b);
+                if (!write_all(w.socket, &count, sizeof(count), true) ||
+                    !write_all(w.socket, points.data() + b * batch_size, count * sizeof(double), true)) {
+                    fail(w);
+                }
+            }
+        };
+
+        size_t done = 0;
+        std::vector<pollfd> fds;
+        std::vector<worker *> polled;
+        try {
+            while (done < num_batches) {
+                for (worker &w: workers) {
+                    fill(w);
+                }
+
+                fds.clear();
+                polled.clear();
+                for (worker &w: workers) {
+                    if (!w.in_flight.empty()) {
+                        fds.push_back({w.socket, POLLIN, 0});
+                        polled.push_back(&w);
+                    }
+                }
+                if (poll(fds.data(), fds.size(), -1) < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error("Could not wait for the workers");
+                }
+
+                for (size_t i = 0; i < fds.size(); i++) {
+                    if (fds[i].revents == 0) {
+                        continue;
+                    }
+                    worker &w = *polled[i];
+                    size_t b = w.in_flight.front();
+
+                    // Read one response. The worker answers the batches in the order they were sent.
+                    uint32_t count;
+                    if (!read_all(w.socket, &count, sizeof(count)) || count != batch_length(b) ||
+                        !read_all(w.socket, values.data() + b * batch_size, count * sizeof(double))) {
+                        fail(w);
+                        continue;
+                    }
+                    w.in_flight.pop_front();
+                    done++;
+                }
+            }
+        } catch (...) {
+            // The other workers may still be working on batches of this call, and their indices would be
+            // meaningless in the next call.
+            restart_busy();
+            throw;
+        }
+    }
+
+    double ProcessPool::evaluate(double x) {
+        std::vector<double> points = {x}, values;
+        evaluate(points, values);
+        return values[0];
+    }
+
+    unsigned int ProcessPool::get_restarts() const {
+        return restarts;
+    }
+
+    int serve(int in, int out, const std::function<double(double)> &f) {
+        std::vector<double> batch;
+        while (true) {
+            uint32_t count;
+            if (!read_all(in, &count, sizeof(count))) {
+                // The pool closed the connection.
+                return 0;
+            }
+            batch.resize(count);
+            if (!read_all(in, batch.data(), count * sizeof(double))) {
+                return 1;
+            }
+            for (double &x: batch) {
+                x = f(x);
+            }
+            if (!write_all(out, &count, sizeof(count), false) ||
+                !write_all(out, batch.data(), count * sizeof(double), false)) {
+                return 1;
+            }
+        }
+    }
+}
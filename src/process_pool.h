@@ -0,0 +1,120 @@
+//
+// Created by visan on 5/18/23.
+//
+
+#ifndef GENETICSIMULATION_PROCESS_POOL_H
+#define GENETICSIMULATION_PROCESS_POOL_H
+
+#include<cstdint>
+#include<deque>
+#include<functional>
+#include<string>
+#include<vector>
+#include<sys/types.h>
+
+namespace GeneticSimulation {
+    /*
+     * This class evaluates a function in a pool of long-lived worker processes, for functions that cannot be
+     * linked into the optimiser (for example simulators).
+     * The workers communicate with the pool over a Unix socket connected to their stdin and stdout.
+     * Every request is a batch of points and every response is the batch of values, in the same order.
+     * Both are framed the same way: a 32-bit count followed by count doubles, in the native byte order.
+     * The points are split into batches that are spread over the workers, and every worker has up to
+     * two batches in flight, so that it never waits for the pool. If a worker crashes, it is restarted and
+     * its batches are sent again.
+     */
+    class ProcessPool {
+    public:
+        /*
+         * The largest batch size. Two batches in flight, in each direction, must fit in the buffers of the socket,
+         * otherwise the pool and the worker could both block while writing.
+         */
+        static constexpr unsigned int max_batch_size = 4096;
+
+    private:
+        /*
+         * A worker process and the batches it is working on.
+         */
+        struct worker {
+            pid_t pid = -1;
+            // The pool's end of the socket.
+            int socket = -1;
+            // The indices of the batches sent to the worker, in order.
+            std::deque<size_t> in_flight;
+        };
+
+        /*
+         * The command that starts a worker, and its arguments.
+         */
+        std::vector<std::string> command;
+
+        /*
+         * The maximum number of points sent in a request.
+         */
+        unsigned int batch_size;
+
+        /*
+         * The number of times a batch is sent again after a crash before giving up.
+         */
+        unsigned int max_retries;
+
+        std::vector<worker> workers;
+
+        /*
+         * The number of times a worker was restarted.
+         */
+        unsigned int restarts;
+
+        /*
+         * Starts the process of the given worker.
+         */
+        void spawn(worker &w);
+
+        /*
+         * Stops the process of the given worker.
+         */
+        void stop(worker &w);
+
+        /*
+         * Restarts every worker that has batches in flight, so that their responses are not read by the next call.
+         * It is used when a call is abandoned.
+         */
+        void restart_busy();
+
+    public:
+        ProcessPool(std::vector<std::string> _command, unsigned int num_workers, unsigned int _batch_size = 256,
+                    unsigned int _max_retries = 3);
+
+        ~ProcessPool();
+
+        ProcessPool(const ProcessPool &) = delete;
+
+        ProcessPool &operator=(const ProcessPool &) = delete;
+
+        /*
+         * Evaluates the function at every given point, and stores the values in the same order.
+         * Throws std::runtime_error if a batch fails more than max_retries times. The pool can still be used
+         * after that.
+         */
+        void evaluate(const std::vector<double> &points, std::vector<double> &values);
+
+        /*
+         * Evaluates the function at a single point.
+         */
+        double evaluate(double x);
+
+        /*
+         * Returns the number of times a worker was restarted.
+         */
+        unsigned int get_restarts() const;
+    };
+
+    /*
+     * Runs the worker side of the protocol: reads batches of points from the input file descriptor and writes
+     * the values of the function to the output file descriptor, until the input is closed.
+     * Returns 0 if the input was closed cleanly.
+     */
+    int serve(int in, int out, const std::function<double(double)> &f);
+}
+
+#endif //GENETICSIMULATION_PROCESS_POOL_H
@@ -0,0 +1,368 @@
+//
+// Created by visan on 5/27/23.
+//
+
+#ifndef GENETICSIMULATION_REAL_ENGINE_H
+#define GENETICSIMULATION_REAL_ENGINE_H
+
+#include<algorithm>
+#include<cmath>
+#include<iostream>
+#include<memory>
+#include<vector>
+#include "defines.h"
+#include "adaptive.h"
+#include "engine.h"
+#include "sampling.h"
+#include "trace.h"
+
+namespace GeneticSimulation {
+    /*
+     * The operators of the real-coded engine work on the genes directly: a gene is the point of the domain itself,
+     * so the precision is not limited by a number of bits, and evaluating an organism needs no decoding.
+     * Every operator keeps the genes in the domain by clamping them.
+     */
+
+    /*
+     * Cross-over policy: blend cross-over, BLX-alpha. Both children are drawn uniformly from the interval spanned by
+     * the parents, extended by alpha times its length on both sides.
+     */
+    struct BlendCrossover {
+        double alpha = 0.5;
+
+        template<typename Trace>
+        void cross(double &a, double &b, range domain, std::ostream &out) const {
+            double low = std::min(a, b), high = std::max(a, b);
+            double extension = alpha * (high - low);
+            low -= extension;
+            high += extension;
+            a = std::clamp(low + uniform(rng) * (high - low), domain.left, domain.right);
+            b = std::clamp(low + uniform(rng) * (high - low), domain.left, domain.right);
+            if constexpr (Trace::enabled) {
+                out << "Blend in [" << low << ", " << high << "]: " << a << " " << b << std::endl;
+            }
+        }
+    };
+
+    /*
+     * Cross-over policy: simulated binary cross-over, SBX. The children are spread symmetrically around the mean
+     * of the parents, by a factor drawn so that children close to the parents are more likely. A larger
+     * distribution index eta gives children closer to their parents.
+     */
+    struct SimulatedBinaryCrossover {
+        double eta = 2;
+
+        template<typename Trace>
+        void cross(double &a, double &b, range domain, std::ostream &out) const {
+            double u = uniform(rng);
+            double beta = u <= 0.5 ? std::pow(2 * u, 1 / (eta + 1)) : std::pow(1 / (2 * (1 - u)), 1 / (eta + 1));
+            double mean = (a + b) / 2, half = (b - a) / 2;
+            a = std::clamp(mean - beta * half, domain.left, domain.right);
+            b = std::clamp(mean + beta * half, domain.left, domain.right);
+            if constexpr (Trace::enabled) {
+                out << "Spread factor: " << beta << ", children: " << a << " " << b << std::endl;
+            }
+        }
+    };
+
+    /*
+     * Mutation policy: adds a normal perturbation with a standard deviation of sigma times the length of the domain.
+     */
+    struct GaussianMutation {
+        double sigma = 0.1;
+
+        template<typename Trace>
+        void mutate(double &x, range domain, std::ostream &out) const {
+            double before = x;
+            x = std::clamp(x + sigma * (domain.right - domain.left) * normal(rng), domain.left, domain.right);
+            if constexpr (Trace::enabled) {
+                out << "Mutating " << before << " to " << x << std::endl;
+            }
+        }
+    };
+
+    /*
+     * Mutation policy: polynomial mutation. The perturbation is at most the length of the domain, and small
+     * perturbations are more likely. A larger distribution index eta gives smaller perturbations.
+     */
+    struct PolynomialMutation {
+        double eta = 20;
+
+        template<typename Trace>
+        void mutate(double &x, range domain, std::ostream &out) const {
+            double u = uniform(rng);
+            double delta = u < 0.5 ? std::pow(2 * u, 1 / (eta + 1)) - 1 : 1 - std::pow(2 * (1 - u), 1 / (eta + 1));
+            double before = x;
+            x = std::clamp(x + delta * (domain.right - domain.left), domain.left, domain.right);
+            if constexpr (Trace::enabled) {
+                out << "Mutating " << before << " to " << x << std::endl;
+            }
+        }
+    };
+
+    /*
+     * A genetic optimiser with real-coded organisms: the population is a contiguous array of points of the domain.
+     * An epoch works like an epoch of Engine: the fittest organism is kept, and the rest of the next generation is
+     * created by selection, cross-over and mutation. The selection policies are the ones of Engine. Organisms are
+     * chosen for cross-over and mutation with the given probabilities, and the chosen organisms are paired in order,
+     * the last one with the first one if they are odd.
+     * If a resolution is set, the genes are rounded to the points domain.left + k * resolution, so a resolution of
+     * 1 on a domain with integer ends gives integer genes.
+     */
+    template<typename Selection = RouletteSelection,
+            typename Crossover = SimulatedBinaryCrossover,
+            typename Mutation = PolynomialMutation,
+            typename Trace = NoTrace,
+            typename Function = double (*)(double)>
+    class RealEngine {
+    private:
+        Function f;
+        unsigned int population_size;
+        range domain;
+        double cross_probability;
+        double mutation_probability;
+        Crossover crossover;
+        Mutation mutation;
+
+        /*
+         * The distance between two genes of an integer representation, or 0 for a continuous one.
+         */
+        double resolution;
+
+        /*
+         * The number of times the function was evaluated.
+         */
+        unsigned long long evaluations;
+
+        /*
+         * Whether the statistics of every epoch are recorded, and the statistics of the epochs of the last run.
+         */
+        bool record_telemetry;
+        std::vector<epoch_stats> telemetry;
+        unsigned int epoch;
+
+        /*
+         * The stream the trace is written to, and the stream that discards it, if the output is disabled.
+         */
+        std::ostream *output;
+        std::unique_ptr<std::ostream> discarded;
+
+        /*
+         * The current population, the fitness of every organism and the scratch buffers of the stages.
+         * They are allocated once, in the constructor.
+         */
+        std::vector<double> population;
+        std::vector<double> selected;
+        std::vector<double> fitness;
+        std::vector<double> intervals;
+        std::vector<size_t> chosen;
+
+        /*
+         * Rounds the given gene to the resolution, if there is one.
+         */
+        double snap(double x) const {
+            if (resolution <= 0) {
+                return x;
+            }
+            double snapped = domain.left + std::round((x - domain.left) / resolution) * resolution;
+            return std::min(snapped, domain.right);
+        }
+
+        /*
+         * Computes the fitness of every organism and returns the index of the fittest one.
+         */
+        size_t evaluate() {
+            fitness.clear();
+            size_t best = 0;
+            for (size_t i = 0; i < population.size(); i++) {
+                fitness.push_back(f(population[i]));
+                if (fitness[i] > fitness[best]) {
+                    best = i;
+                }
+            }
+            evaluations += population.size();
+            return best;
+        }
+
+        /*
+         * Returns the spread of the population: its standard deviation relative to half the length of the domain,
+         * in [0, 1]. It is 0 when all organisms are identical.
+         */
+        double diversity() const {
+            double mean = 0, variance = 0;
+            for (double x: population) {
+                mean += x;
+            }
+            mean /= (double) population.size();
+            for (double x: population) {
+                variance += (x - mean) * (x - mean);
+            }
+            variance /= (double) population.size();
+            return std::min(1.0, 2 * std::sqrt(variance) / (domain.right - domain.left));
+        }
+
+        /*
+         * Records the statistics of the last evaluated population.
+         */
+        void record(size_t best) {
+            double sum = 0;
+            for (double ft: fitness) {
+                sum += ft;
+            }
+            telemetry.push_back({epoch, evaluations, fitness[best], sum / (double) fitness.size(), diversity(),
+                                 cross_probability, mutation_probability});
+        }
+
+        /*
+         * Chooses every organism of the given population with the given probability, and stores their indices.
+         */
+        void choose(const std::vector<double> &organisms, double probability) {
+            chosen.clear();
+            for (size_t i = 0; i < organisms.size(); i++) {
+                if (uniform(rng) < probability) {
+                    chosen.push_back(i);
+                }
+            }
+        }
+
+    public:
+        RealEngine(Function _function, unsigned int _population_size, range _domain, double _cross_probability,
+                   double _mutation_probability, Crossover _crossover = Crossover(), Mutation _mutation = Mutation()) :
+                f(_function),
+                population_size(_population_size),
+                domain(_domain),
+                cross_probability(_cross_probability),
+                mutation_probability(_mutation_probability),
+                crossover(_crossover),
+                mutation(_mutation),
+                resolution(0),
+                evaluations(0),
+                record_telemetry(false),
+                epoch(0),
+                output(&std::cout) {
+            population.reserve(population_size);
+            selected.reserve(population_size);
+            fitness.reserve(population_size);
+            intervals.reserve(population_size);
+            chosen.reserve(population_size);
+        }
+
+        /*
+         * Generates the initial population. It consists of uniformly distributed points of the domain.
+         */
+        void initialise() {
+            population.clear();
+            for (unsigned int i = 0; i < population_size; i++) {
+                population.push_back(snap(domain.left + uniform(rng) * (domain.right - domain.left)));
+            }
+            telemetry.clear();
+            epoch = 0;
+        }
+
+        /*
+         * Replaces the population with the next generation: the fittest organism, and population_size - 1 organisms
+         * created by selection, cross-over and mutation.
+         */
+        void step() {
+            if (population.empty()) {
+                return;
+            }
+            size_t best_index = evaluate();
+            if (record_telemetry) {
+                record(best_index);
+            }
+            epoch++;
+            double best = population[best_index];
+
+            Selection::template select<double, 0, Trace>(population, fitness, population.size() - 1, selected,
+                                                         intervals, *output);
+
+            choose(selected, cross_probability);
+            size_t index = 0;
+            while (index + 1 < chosen.size()) {
+                crossover.template cross<Trace>(selected[chosen[index]], selected[chosen[index + 1]], domain,
+                                                *output);
+                index += 2;
+            }
+            if (index < chosen.size()) {
+                crossover.template cross<Trace>(selected[chosen[index]], selected[chosen[0]], domain, *output);
+            }
+
+            choose(selected, mutation_probability);
+            for (size_t i: chosen) {
+                mutation.template mutate<Trace>(selected[i], domain, *output);
+            }
+
+            if (resolution > 0) {
+                for (double &x: selected) {
+                    x = snap(x);
+                }
+            }
+            selected.push_back(best);
+            std::swap(population, selected);
+        }
+
+        /*
+         * Simulates the given number of epochs, starting from a random population, and returns the best point
+         * of the last population.
+         */
+        double run(unsigned int epochs) {
+            initialise();
+            for (unsigned int e = 0; e < epochs; e++) {
+                step();
+            }
+            return population[evaluate()];
+        }
+
+        /*
+         * Sets the distance between two genes, so that the genes are integers (in units of the resolution).
+         * Passing 0 makes the genes continuous, which is the default.
+         */
+        void set_resolution(double _resolution) {
+            resolution = _resolution;
+        }
+
+        /*
+         * Sets the stream the trace is written to. It is std::cout by default, and null disables the output.
+         * Nothing is written unless the Trace policy enables it.
+         */
+        void set_output(std::ostream *stream) {
+            if (stream == nullptr) {
+                // A stream without a buffer discards everything written to it.
+                discarded = std::make_unique<std::ostream>(nullptr);
+                stream = discarded.get();
+            }
+            output = stream;
+        }
+
+        /*
+         * Enables or disables recording the statistics of every epoch.
+         */
+        void set_telemetry(bool enabled) {
+            record_telemetry = enabled;
+        }
+
+        /*
+         * Returns the statistics of every epoch of the last run. It is empty if telemetry is disabled.
+         */
+        const std::vector<epoch_stats> &get_telemetry() const {
+            return telemetry;
+        }
+
+        /*
+         * Returns the number of times the function was evaluated.
+         */
+        unsigned long long get_evaluations() const {
+            return evaluations;
+        }
+
+        /*
+         * Returns the current population.
+         */
+        const std::vector<double> &get_population() const {
+            return population;
+        }
+    };
+}
+
+#endif //GENETICSIMULATION_REAL_ENGINE_H
@@ -0,0 +1,176 @@
+//
+// Created by visan on 5/24/23.
+//
+
+#include "recording.h"
+#include<algorithm>
+#include<cmath>
+#include<iomanip>
+#include<limits>
+#include<map>
+#include<sstream>
+#include<stdexcept>
+#include<string>
+
+namespace GeneticSimulation {
+    bool epoch_digest::operator==(const epoch_digest &other) const {
+        return epoch == other.epoch && population_hash == other.population_hash &&
+               evaluations == other.evaluations && max_fitness == other.max_fitness &&
+               average_fitness == other.average_fitness;
+    }
+
+    bool epoch_digest::operator!=(const epoch_digest &other) const {
+        return !(*this == other);
+    }
+
+    double run_record::best_fitness() const {
+        double best = 0;
+        for (const epoch_digest &digest: epochs) {
+            best = std::max(best, digest.max_fitness);
+        }
+        return best;
+    }
+
+    uint64_t population_digest(const std::vector<Organism> &population) {
+        uint64_t hash = 14695981039346656037ull;
+        for (const Organism &organism: population) {
+            bitvector chromosome = organism.get_chromosome();
+            for (unsigned int byte = 0; byte < sizeof(bitvector); byte++) {
+                hash ^= (chromosome >> (8 * byte)) & 0xff;
+                hash *= 1099511628211ull;
+            }
+        }
+        return hash;
+    }
+
+    void save_runs(std::ostream &os, const std::vector<run_record> &runs) {
+        os << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (const run_record &run: runs) {
+            os << "run " << run.seed << '\n';
+            for (const epoch_digest &digest: run.epochs) {
+                os << digest.epoch << ' ' << std::hex << digest.population_hash << std::dec << ' '
+                   << digest.evaluations << ' ' << digest.max_fitness << ' ' << digest.average_fitness << '\n';
+            }
+        }
+    }
+
+    std::vector<run_record> load_runs(std::istream &is) {
+        std::vector<run_record> runs;
+        std::string line;
+        while (std::getline(is, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            std::istringstream fields(line);
+            if (line.compare(0, 4, "run ") == 0) {
+                std::string word;
+                run_record run{};
+                if (!(fields >> word >> run.seed)) {
+                    throw std::runtime_error("Malformed run: " + line);
+                }
+                runs.push_back(run);
+                continue;
+            }
+
+            epoch_digest digest{};
+            if (runs.empty() || !(fields >> digest.epoch >> std::hex >> digest.population_hash >> std::dec
+                                         >> digest.evaluations >> digest.max_fitness >> digest.average_fitness)) {
+                throw std::runtime_error("Malformed epoch: " + line);
+            }
+            runs.back().epochs.push_back(digest);
+        }
+        return runs;
+    }
+
+    /*
+     * Returns the z statistic of the Mann-Whitney U test of the two samples, with the normal approximation and
+     * the correction for ties. It is 0 if all the values are equal.
+     */
+    static double mann_whitney(const std::vector<double> &a, const std::vector<double> &b) {
+        std::vector<std::pair<double, bool>> values;
+        for (double x: a) {
+            values.emplace_back(x, true);
+        }
+        for (double x: b) {
+            values.emplace_back(x, false);
+        }
+        std::sort(values.begin(), values.end());
+
+        // Sum the ranks of the first sample. Tied values get the average of their ranks.
+        auto n = (double) values.size();
+        double rank_sum = 0, ties = 0;
+        size_t i = 0;
+        while (i < values.size()) {
+            size_t j = i;
+            while (j < values.size() && values[j].first == values[i].first) {
+                j++;
+            }
+            double rank = (double) (i + j + 1) / 2;
+            auto t = (double) (j - i);
+            ties += t * t * t - t;
+            for (size_t k = i; k < j; k++) {
+                if (values[k].second) {
+                    rank_sum += rank;
+                }
+            }
+            i = j;
+        }
+
+        auto n1 = (double) a.size(), n2 = (double) b.size();
+        double u = rank_sum - n1 * (n1 + 1) / 2;
+        double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+        if (variance <= 0) {
+            return 0;
+        }
+        return (u - n1 * n2 / 2) / std::sqrt(variance);
+    }
+
+    comparison compare_runs(const std::vector<run_record> &a, const std::vector<run_record> &b, double z_critical) {
+        if (a.size() != b.size()) {
+            throw std::runtime_error("The recordings have a different number of runs");
+        }
+        // The runs of the second recording, by seed.
+        std::map<std::mt19937::result_type, const run_record *> by_seed;
+        for (const run_record &run: b) {
+            if (!by_seed.emplace(run.seed, &run).second) {
+                throw std::runtime_error("A recording has two runs with the seed " + std::to_string(run.seed));
+            }
+        }
+
+        comparison result{comparison::Verdict::identical, 0, 0, 0, 0};
+        std::vector<double> best_a, best_b;
+        for (const run_record &run: a) {
+            auto match = by_seed.find(run.seed);
+            if (match == by_seed.end()) {
+                throw std::runtime_error("The recordings were made with different seeds");
+            }
+            const run_record &other = *match->second;
+            // Remove the match, so that a seed repeated in the first recording is reported.
+            by_seed.erase(match);
+            best_a.push_back(run.best_fitness());
+            best_b.push_back(other.best_fitness());
+
+            // A run that stopped earlier diverges at the first epoch missing from it.
+            const std::vector<epoch_digest> &x = run.epochs, &y = other.epochs;
+            size_t epoch = 0;
+            while (epoch < x.size() && epoch < y.size() && x[epoch] == y[epoch]) {
+                epoch++;
+            }
+            if (epoch == x.size() && epoch == y.size()) {
+                continue;
+            }
+            if (result.divergent_runs == 0) {
+                result.first_divergent_seed = run.seed;
+                result.first_divergent_epoch = (unsigned int) epoch;
+            }
+            result.divergent_runs++;
+        }
+
+        result.z = mann_whitney(best_a, best_b);
+        if (result.divergent_runs != 0) {
+            bool equivalent = std::abs(result.z) < z_critical;
+            result.verdict = equivalent ? comparison::Verdict::equivalent : comparison::Verdict::different;
+        }
+        return result;
+    }
+}
@@ -0,0 +1,107 @@
+//
+// Created by visan on 5/24/23.
+//
+
+#ifndef GENETICSIMULATION_RECORDING_H
+#define GENETICSIMULATION_RECORDING_H
+
+#include<cstdint>
+#include<iostream>
+#include<random>
+#include<vector>
+#include "organism.h"
+
+namespace GeneticSimulation {
+    /*
+     * A compact summary of the population of an epoch, used to compare two runs epoch by epoch.
+     */
+    struct epoch_digest {
+        // The index of the epoch.
+        unsigned int epoch;
+
+        // A hash of the chromosomes of the population, in order.
+        uint64_t population_hash;
+
+        // The number of fitness evaluations performed since the start of the run.
+        unsigned long long evaluations;
+
+        // The maximum and the average fitness of the population.
+        double max_fitness;
+        double average_fitness;
+
+        bool operator==(const epoch_digest &other) const;
+
+        bool operator!=(const epoch_digest &other) const;
+    };
+
+    /*
+     * The record of a run: the seed of the random number generator and the digest of every epoch.
+     * Replaying the run with the same seed and the same build reproduces the same digests.
+     */
+    struct run_record {
+        std::mt19937::result_type seed;
+        std::vector<epoch_digest> epochs;
+
+        /*
+         * Returns the best fitness reached during the run, or 0 if no epoch was recorded.
+         */
+        double best_fitness() const;
+    };
+
+    /*
+     * The result of comparing the runs recorded by two builds.
+     */
+    struct comparison {
+        enum class Verdict {
+            // Every run went through the same populations in both builds.
+            identical,
+            // Some runs diverged, but the best fitness reached by the runs is not significantly different.
+            equivalent,
+            // The best fitness reached by the runs is significantly different.
+            different
+        };
+
+        Verdict verdict;
+
+        // The number of runs that diverged.
+        size_t divergent_runs;
+
+        // The seed of the first run that diverged, and the first epoch in which its digests differ.
+        // They are only set if a run diverged.
+        std::mt19937::result_type first_divergent_seed;
+        unsigned int first_divergent_epoch;
+
+        // The statistic of the Mann-Whitney U test on the best fitness of the runs, with the normal approximation.
+        double z;
+    };
+
+    /*
+     * Returns the FNV-1a hash of the chromosomes of the given population.
+     */
+    uint64_t population_digest(const std::vector<Organism> &population);
+
+    /*
+     * Writes the given runs to the given stream, in a line-oriented text format: a line "run <seed>" starts a run,
+     * and every following line is the digest of an epoch. Doubles are written with enough digits to be read back
+     * exactly.
+     */
+    void save_runs(std::ostream &os, const std::vector<run_record> &runs);
+
+    /*
+     * Reads runs written by save_runs. Throws std::runtime_error if the stream is malformed.
+     */
+    std::vector<run_record> load_runs(std::istream &is);
+
+    /*
+     * Compares the runs recorded by two builds. The runs are matched by seed, in any order. Both recordings must
+     * have the same seeds, each one once, otherwise std::runtime_error is thrown. The runs that diverge are found
+     * by comparing their digests epoch by epoch, and the first divergent run is the first one of a that diverged.
+     * If any run diverged, the best fitness reached by the runs of the two builds is compared with a two-sided
+     * Mann-Whitney U test: the builds are equivalent if |z| < z_critical (1.96 is a 5% level).
+     * The test needs at least 8 runs per build to be meaningful.
+     */
+    comparison compare_runs(const std::vector<run_record> &a, const std::vector<run_record> &b,
+                            double z_critical = 1.96);
+}
+
+#endif //GENETICSIMULATION_RECORDING_H
@@ -0,0 +1,144 @@
+//
+// Created by visan on 5/26/23.
+//
+// The convergence regression suite: runs the optimiser many times, with fixed seeds, on standard test functions,
+// and compares the success rate and the evaluations to the target to a stored baseline.
+//
+// Regression <baseline> [--update] [runs=200] [threads=1] [tolerance=0.1] [time_tolerance=inf]
+//
+// With --update, the baseline is replaced by the current results. Otherwise, the exit code is 1 if a metric
+// regressed beyond the tolerance (see find_regressions).
+// The time of a run depends on the machine and the build type, so it is only compared to the baseline when
+// a finite time_tolerance is given. The runs are independent, but with several threads they compete for
+// the cores, so the time is also never compared when the suite runs on several threads.
+//
+#include<cmath>
+#include<cstdlib>
+#include<fstream>
+#include<iomanip>
+#include<iostream>
+#include<limits>
+#include<map>
+#include<sstream>
+#include<string>
+#include"convergence.h"
+#include"objectives.h"
+
+using namespace GeneticSimulation;
+
+/*
+ * A problem of the suite: a built-in objective, the fitness a run must reach, just below the maximum, and
+ * the precision needed to represent a point that reaches it.
+ */
+struct problem {
+    std::string objective;
+    double target;
+    unsigned int precision;
+};
+
+static const std::vector<problem> suite = {
+        {"rastrigin", 49.999,  3},
+        {"ackley",    24.99,   3},
+        {"schwefel",  999.99,  2},
+        {"f",         3.9685,  3},
+        {"g",         6.9906,  4},
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <baseline> [--update] [runs=200] [threads=1] [tolerance=0.1] [time_tolerance=inf]" << std::endl;
+        return 2;
+    }
+    std::string baseline_file = argv[1];
+    bool update = false;
+    std::map<std::string, double> options = {{"runs", 200}, {"threads", 1}, {"tolerance", 0.1},
+                                             {"time_tolerance", std::numeric_limits<double>::infinity()}};
+    for (int i = 2; i < argc; i++) {
+        std::string argument = argv[i];
+        size_t equals = argument.find('=');
+        if (argument == "--update") {
+            update = true;
+        } else if (equals != std::string::npos && options.count(argument.substr(0, equals))) {
+            options[argument.substr(0, equals)] = atof(argument.c_str() + equals + 1);
+        } else {
+            std::cerr << "Unknown argument: " << argument << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<convergence_stats> current;
+    std::cout << std::left << std::setw(10) << "objective" << std::setw(26) << "success rate"
+              << std::setw(34) << "evaluations to target" << "seconds per run" << std::endl;
+    for (const problem &p: suite) {
+        const objective &o = find_objective(p.objective);
+        job configuration{0, o.name, 20, o.domain, p.precision, 0.25, 0.01, 2000, 1, 0, p.target, 1};
+        current.push_back(measure_convergence(configuration, (unsigned int) options["runs"],
+                                              (unsigned int) options["threads"]));
+
+        const convergence_stats &s = current.back();
+        std::ostringstream success, evaluations, seconds;
+        success << std::fixed << std::setprecision(2) << s.success_rate.mean << " [" << s.success_rate.low << ", "
+                << s.success_rate.high << "]";
+        evaluations << std::fixed << std::setprecision(0) << s.evaluations.mean << " [" << s.evaluations.low << ", "
+                    << s.evaluations.high << "]";
+        seconds << std::scientific << std::setprecision(2) << s.seconds.mean << " [" << s.seconds.low << ", "
+                << s.seconds.high << "]";
+        std::cout << std::setw(10) << s.objective << std::setw(26) << success.str() << std::setw(34)
+                  << evaluations.str() << seconds.str() << std::endl;
+    }
+
+    if (update) {
+        std::ofstream os(baseline_file);
+        save_baseline(os, current);
+        if (!os) {
+            std::cerr << "Could not write " << baseline_file << std::endl;
+            return 2;
+        }
+        std::cout << "Baseline updated" << std::endl;
+        return 0;
+    }
+
+    std::ifstream is(baseline_file);
+    if (!is) {
+        std::cerr << "Could not open " << baseline_file << ", run with --update to create it" << std::endl;
+        return 2;
+    }
+    std::vector<convergence_stats> baseline;
+    try {
+        baseline = load_baseline(is);
+    } catch (const std::runtime_error &error) {
+        std::cerr << error.what() << std::endl;
+        return 2;
+    }
+
+    double time_tolerance = options["time_tolerance"];
+    if (options["threads"] != 1 && std::isfinite(time_tolerance)) {
+        std::cout << "The times of runs on several threads are not compared to the baseline" << std::endl;
+        time_tolerance = std::numeric_limits<double>::infinity();
+    }
+
+    size_t regressions = 0;
+    for (const convergence_stats &s: current) {
+        bool found = false;
+        for (const convergence_stats &b: baseline) {
+            if (b.objective != s.objective) {
+                continue;
+            }
+            found = true;
+            for (const std::string &regression: find_regressions(s, b, options["tolerance"], time_tolerance)) {
+                std::cout << "Regression: " << regression << std::endl;
+                regressions++;
+            }
+        }
+        if (!found) {
+            std::cerr << "The baseline has no results for " << s.objective << std::endl;
+            return 2;
+        }
+    }
+    if (regressions != 0) {
+        return 1;
+    }
+    std::cout << "No regressions" << std::endl;
+    return 0;
+}
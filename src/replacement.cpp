@@ -0,0 +1,51 @@
+//
+// Created by visan on 5/22/23.
+//
+
+#include "replacement.h"
+
+namespace GeneticSimulation {
+    Replacement::Replacement(Strategy _strategy, unsigned int _count) : strategy(_strategy), count(_count) {
+    }
+
+    Replacement Replacement::generational(unsigned int elites) {
+        return {Strategy::generational, elites};
+    }
+
+    Replacement Replacement::plus(unsigned int lambda) {
+        return {Strategy::plus, lambda};
+    }
+
+    Replacement Replacement::comma(unsigned int lambda) {
+        return {Strategy::comma, lambda};
+    }
+
+    Replacement Replacement::age(unsigned int lambda) {
+        return {Strategy::age, lambda};
+    }
+
+    Replacement::Strategy Replacement::get_strategy() const {
+        return strategy;
+    }
+
+    size_t Replacement::elites(size_t population_size) const {
+        if (strategy != Strategy::generational) {
+            return 0;
+        }
+        return std::min<size_t>(count, population_size);
+    }
+
+    size_t Replacement::offspring(size_t population_size) const {
+        switch (strategy) {
+            case Strategy::generational:
+                return population_size - elites(population_size);
+            case Strategy::plus:
+                return count;
+            case Strategy::comma:
+                return std::max<size_t>(count, population_size);
+            case Strategy::age:
+                return population_size == 0 ? 0 : std::min<size_t>(count, population_size - 1);
+        }
+        return 0;
+    }
+}
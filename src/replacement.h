@@ -0,0 +1,90 @@
+//
+// Created by visan on 5/22/23.
+//
+
+#ifndef GENETICSIMULATION_REPLACEMENT_H
+#define GENETICSIMULATION_REPLACEMENT_H
+
+#include<algorithm>
+#include<vector>
+
+namespace GeneticSimulation {
+    /*
+     * This class describes how the next population is formed from the current population (the mu parents)
+     * and the offspring created by selection, cross-over and mutation. The strategies are:
+     * - generational: the offspring replace the whole population, except for the fittest k organisms (the elites),
+     * which are passed unchanged to the next generation.
+     * - plus, (mu + lambda): lambda offspring are created, and the fittest mu organisms among the parents and
+     * the offspring survive.
+     * - comma, (mu, lambda): lambda >= mu offspring are created, and the fittest mu offspring survive. The parents
+     * are always discarded.
+     * - age: lambda offspring replace the lambda oldest organisms. The age of an organism is the number of
+     * generations it has survived. The fittest organism is never replaced.
+     * With the plus, comma and age strategies the offspring are evaluated while the next generation is formed,
+     * so the fitness of the survivors is not computed again.
+     */
+    class Replacement {
+    public:
+        enum class Strategy {
+            generational, plus, comma, age
+        };
+
+    private:
+        Strategy strategy;
+
+        /*
+         * The number of elites, for the generational strategy, and the number of offspring (lambda), for
+         * the other strategies.
+         */
+        unsigned int count;
+
+        Replacement(Strategy _strategy, unsigned int _count);
+
+    public:
+        /*
+         * The generational strategy with the given number of elites. It is the default.
+         */
+        static Replacement generational(unsigned int elites = 1);
+
+        /*
+         * The (mu + lambda) strategy.
+         */
+        static Replacement plus(unsigned int lambda);
+
+        /*
+         * The (mu, lambda) strategy. If lambda is smaller than the population size, the population size is used.
+         */
+        static Replacement comma(unsigned int lambda);
+
+        /*
+         * The age-based strategy. At most population size - 1 offspring are created.
+         */
+        static Replacement age(unsigned int lambda);
+
+        Strategy get_strategy() const;
+
+        /*
+         * Returns the number of elites kept by the generational strategy, at most population_size.
+         */
+        size_t elites(size_t population_size) const;
+
+        /*
+         * Returns the number of offspring created every generation for a population of the given size.
+         */
+        size_t offspring(size_t population_size) const;
+    };
+
+    /*
+     * Reorders the given indices so that the first k are the best ones, according to the better comparator,
+     * in no particular order. It runs in linear time on average, instead of sorting all the indices.
+     */
+    template<typename Better>
+    void top_k(std::vector<size_t> &indices, size_t k, Better better) {
+        if (k == 0 || k >= indices.size()) {
+            return;
+        }
+        std::nth_element(indices.begin(), indices.begin() + (long) k - 1, indices.end(), better);
+    }
+}
+
+#endif //GENETICSIMULATION_REPLACEMENT_H
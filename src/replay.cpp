@@ -0,0 +1,95 @@
+//
+// Created by visan on 5/24/23.
+//
+// Records runs of the optimiser and compares the recordings of two builds.
+//
+// Replay record <file> [runs] [epochs] [first seed]
+//     Runs the optimiser on the built-in objective g, as in main, once per seed, and writes the digests of every
+//     epoch to the file.
+// Replay compare <baseline> <candidate>
+//     Reports the first epoch in which the runs of the two recordings diverge, and whether the builds are
+//     identical, statistically equivalent or different. The exit code is 1 if they are different.
+//
+#include<cstdlib>
+#include<fstream>
+#include<iostream>
+#include<stdexcept>
+#include<string>
+#include"objectives.h"
+#include"optimiser.h"
+#include"recording.h"
+
+using namespace GeneticSimulation;
+
+static int record(const std::string &file, unsigned int runs, unsigned int epochs,
+                  std::mt19937::result_type first_seed) {
+    const objective &g = find_objective("g");
+    std::vector<run_record> records;
+    for (unsigned int r = 0; r < runs; r++) {
+        Optimiser opt(g.function, 10, g.domain, 6, 0.25, 0.01, epochs);
+        opt.set_recording(true, first_seed + r);
+        opt.set_output(nullptr);
+        opt.optimise();
+
+        records.push_back(opt.get_recording());
+        std::cout << "Run " << r + 1 << "/" << runs << ": seed " << first_seed + r << ", best fitness "
+                  << records.back().best_fitness() << std::endl;
+    }
+
+    std::ofstream os(file);
+    save_runs(os, records);
+    return os ? 0 : 2;
+}
+
+static int compare(const std::string &baseline, const std::string &candidate) {
+    std::ifstream a(baseline), b(candidate);
+    if (!a || !b) {
+        std::cerr << "Could not open the recordings" << std::endl;
+        return 2;
+    }
+    std::vector<run_record> runs_a, runs_b;
+    comparison result{};
+    try {
+        runs_a = load_runs(a);
+        runs_b = load_runs(b);
+        result = compare_runs(runs_a, runs_b);
+    } catch (const std::runtime_error &error) {
+        std::cerr << error.what() << std::endl;
+        return 2;
+    }
+
+    std::cout << "Runs: " << runs_a.size() << ", divergent: " << result.divergent_runs << std::endl;
+    if (result.divergent_runs != 0) {
+        std::cout << "First divergence: seed " << result.first_divergent_seed << ", epoch "
+                  << result.first_divergent_epoch << std::endl;
+    }
+    std::cout << "Best fitness: z = " << result.z << std::endl;
+
+    switch (result.verdict) {
+        case comparison::Verdict::identical:
+            std::cout << "Verdict: identical" << std::endl;
+            return 0;
+        case comparison::Verdict::equivalent:
+            std::cout << "Verdict: statistically equivalent" << std::endl;
+            return 0;
+        case comparison::Verdict::different:
+            std::cout << "Verdict: different" << std::endl;
+            return 1;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 3 && std::string(argv[1]) == "record") {
+        unsigned int runs = argc > 3 ? atoi(argv[3]) : 10;
+        unsigned int epochs = argc > 4 ? atoi(argv[4]) : 1000;
+        std::mt19937::result_type first_seed = argc > 5 ? strtoul(argv[5], nullptr, 10) : 1;
+        return record(argv[2], runs, epochs, first_seed);
+    }
+    if (argc == 4 && std::string(argv[1]) == "compare") {
+        return compare(argv[2], argv[3]);
+    }
+    std::cerr << "Usage: " << argv[0] << " record <file> [runs] [epochs] [first seed]" << std::endl;
+    std::cerr << "       " << argv[0] << " compare <baseline> <candidate>" << std::endl;
+    return 2;
+}
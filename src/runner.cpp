@@ -0,0 +1,60 @@
+//
+// Created by visan on 5/25/23.
+//
+// Runs a batch experiment described by a configuration file and by key=value arguments, which override the file.
+// See experiment.h for the settings.
+//
+// Runner [config file] [key=value ...]
+//
+#include<fstream>
+#include<iostream>
+#include<stdexcept>
+#include<string>
+#include"experiment.h"
+
+using namespace GeneticSimulation;
+
+int main(int argc, char **argv) {
+    Experiment experiment;
+    try {
+        // Read the configuration files first, so that the arguments override them.
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+            if (argument.find('=') != std::string::npos) {
+                continue;
+            }
+            std::ifstream config(argument);
+            if (!config) {
+                std::cerr << "Could not open " << argument << std::endl;
+                return 2;
+            }
+            experiment.load(config);
+        }
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+            size_t equals = argument.find('=');
+            if (equals != std::string::npos) {
+                experiment.set(argument.substr(0, equals), argument.substr(equals + 1));
+            }
+        }
+
+        std::vector<job> jobs = experiment.jobs();
+        std::cerr << "Running " << jobs.size() << " jobs" << std::endl;
+        std::vector<job_result> results = run_jobs(jobs, experiment.threads(), experiment.telemetry());
+
+        if (experiment.summary() == "-") {
+            write_summary(std::cout, results, experiment.format());
+            return 0;
+        }
+        std::ofstream os(experiment.summary());
+        write_summary(os, results, experiment.format());
+        if (!os) {
+            std::cerr << "Could not write " << experiment.summary() << std::endl;
+            return 2;
+        }
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+//
+// Created by visan on 5/21/23.
+//
+
+#include "sampling.h"
+#include<cmath>
+#include<limits>
+
+namespace GeneticSimulation {
+    void fill_uniform(std::mt19937 &generator, double *values, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = uniform(generator);
+        }
+    }
+
+    void fill_bounded(std::mt19937 &generator, uint32_t range, uint32_t *values, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = bounded(generator, range);
+        }
+    }
+
+    double normal(std::mt19937 &generator) {
+        // 1 - u is in (0, 1], so the logarithm is finite.
+        double radius = std::sqrt(-2 * std::log(1 - uniform(generator)));
+        return radius * std::cos(2 * M_PI * uniform(generator));
+    }
+
+    uint64_t geometric(std::mt19937 &generator, double probability) {
+        if (probability >= 1) {
+            return 0;
+        }
+        // Invert the distribution function. 1 - u is in (0, 1], so the logarithm is finite.
+        double failures = std::floor(std::log(1 - uniform(generator)) / std::log1p(-probability));
+        if (failures >= (double) std::numeric_limits<uint64_t>::max()) {
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return (uint64_t) failures;
+    }
+}
@@ -0,0 +1,73 @@
+//
+// Created by visan on 5/21/23.
+//
+
+#ifndef GENETICSIMULATION_SAMPLING_H
+#define GENETICSIMULATION_SAMPLING_H
+
+#include<cstdint>
+#include<cstddef>
+#include<random>
+
+namespace GeneticSimulation {
+    /*
+     * Sampling primitives built directly on the output of std::mt19937, which is fully specified by the standard.
+     * Unlike the std distributions, whose algorithms are left to the implementation, the integer and uniform samplers
+     * give the same sequences with every compiler and standard library. The normal and geometric samplers use the
+     * same draws, but they go through log, cos and sqrt, whose last bits may differ between math libraries.
+     * The samplers are also cheaper, since no distribution object is built.
+     * The scalar functions are defined here, so that they can be inlined in the hot loops.
+     */
+
+    /*
+     * Returns a uniform integer in [0, range), with Lemire's multiply-and-reject method. The result is unbiased,
+     * and a second number is drawn only with probability less than range / 2^32. The range must not be 0.
+     */
+    inline uint32_t bounded(std::mt19937 &generator, uint32_t range) {
+        uint64_t product = (uint64_t) generator() * range;
+        auto low = (uint32_t) product;
+        if (low < range) {
+            // Reject the products that fall in the incomplete interval, 2^32 mod range of them.
+            uint32_t threshold = (uint32_t) (-range) % range;
+            while (low < threshold) {
+                product = (uint64_t) generator() * range;
+                low = (uint32_t) product;
+            }
+        }
+        return (uint32_t) (product >> 32);
+    }
+
+    /*
+     * Returns a uniform double in [0, 1), with 53 random bits taken from two numbers of the generator.
+     */
+    inline double uniform(std::mt19937 &generator) {
+        uint32_t high = generator() >> 5;
+        uint32_t low = generator() >> 6;
+        return ((double) high * 67108864.0 + (double) low) * (1.0 / 9007199254740992.0);
+    }
+
+    /*
+     * Fills the given array with uniform doubles in [0, 1). It gives the same numbers as calling uniform
+     * count times.
+     */
+    void fill_uniform(std::mt19937 &generator, double *values, size_t count);
+
+    /*
+     * Fills the given array with uniform integers in [0, range). It gives the same numbers as calling bounded
+     * count times.
+     */
+    void fill_bounded(std::mt19937 &generator, uint32_t range, uint32_t *values, size_t count);
+
+    /*
+     * Returns a standard normal double, with the Box-Muller transform of two uniform doubles.
+     */
+    double normal(std::mt19937 &generator);
+
+    /*
+     * Returns the number of failures before the first success of Bernoulli trials with the given probability
+     * of success, which must be in (0, 1].
+     */
+    uint64_t geometric(std::mt19937 &generator, double probability);
+}
+
+#endif //GENETICSIMULATION_SAMPLING_H
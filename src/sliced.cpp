@@ -0,0 +1,175 @@
+//
+// Created by visan on 5/20/23.
+//
+
+#include "sliced.h"
+#include "sampling.h"
+#include<bitset>
+#include<cmath>
+
+namespace GeneticSimulation {
+    /*
+     * Returns 64 random bits.
+     */
+    static uint64_t random_word() {
+        return ((uint64_t) rng() << 32) | rng();
+    }
+
+    /*
+     * Returns a word where every bit is set with the given probability, rounded to 16 binary digits.
+     * It combines random words following the binary expansion of the probability, from the last digit to
+     * the first: a digit 1 ORs the mask with a random word, a digit 0 ANDs it.
+     */
+    static uint64_t random_mask(double probability) {
+        if (probability <= 0) {
+            return 0;
+        }
+        if (probability >= 1) {
+            return ~0ull;
+        }
+        auto digits = (uint32_t) std::lround(probability * 65536);
+        if (digits == 0) {
+            return 0;
+        }
+        if (digits >= 65536) {
+            return ~0ull;
+        }
+        // Trailing zero digits do not change the mask, since it starts empty.
+        unsigned int count = 16;
+        while ((digits & 1) == 0) {
+            digits >>= 1;
+            count--;
+        }
+
+        uint64_t mask = 0;
+        for (unsigned int i = 0; i < count; i++, digits >>= 1) {
+            mask = (digits & 1) ? (mask | random_word()) : (mask & random_word());
+        }
+        return mask;
+    }
+
+    /*
+     * Rotates the bits of the given word to the left.
+     */
+    static uint64_t rotate_left(uint64_t word, unsigned int shift) {
+        shift &= 63;
+        return shift == 0 ? word : (word << shift) | (word >> (64 - shift));
+    }
+
+    void transpose64(uint64_t rows[64]) {
+        // Swap the off-diagonal blocks of size 32, then of size 16 inside every block, and so on.
+        uint64_t mask = 0x00000000FFFFFFFFull;
+        for (unsigned int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+            for (unsigned int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+                uint64_t t = ((rows[k] >> j) ^ rows[k | j]) & mask;
+                rows[k] ^= t << j;
+                rows[k | j] ^= t;
+            }
+        }
+    }
+
+    SlicedPopulation::SlicedPopulation(unsigned int _bits, size_t _size) :
+            bits(_bits),
+            size(_size),
+            blocks((_size + 63) / 64),
+            planes(blocks * _bits, 0) {
+
+    }
+
+    SlicedPopulation SlicedPopulation::random_population(unsigned int bits, size_t size) {
+        SlicedPopulation population(bits, size);
+        for (size_t block = 0; block < population.blocks; block++) {
+            for (unsigned int gene = 0; gene < bits; gene++) {
+                population.planes[block * bits + gene] = random_word() & population.used_lanes(block);
+            }
+        }
+        return population;
+    }
+
+    uint64_t SlicedPopulation::used_lanes(size_t block) const {
+        size_t used = size - block * 64;
+        return used >= 64 ? ~0ull : (1ull << used) - 1;
+    }
+
+    size_t SlicedPopulation::get_size() const {
+        return size;
+    }
+
+    unsigned int SlicedPopulation::get_bits() const {
+        return bits;
+    }
+
+    bitvector SlicedPopulation::get(size_t index) const {
+        const uint64_t *block = planes.data() + (index / 64) * bits;
+        unsigned int lane = index % 64;
+        bitvector chromosome = 0;
+        for (unsigned int gene = 0; gene < bits; gene++) {
+            chromosome |= ((block[gene] >> lane) & 1) << gene;
+        }
+        return chromosome;
+    }
+
+    void SlicedPopulation::set(size_t index, bitvector chromosome) {
+        uint64_t *block = planes.data() + (index / 64) * bits;
+        unsigned int lane = index % 64;
+        for (unsigned int gene = 0; gene < bits; gene++) {
+            block[gene] = (block[gene] & ~(1ull << lane)) | (((chromosome >> gene) & 1) << lane);
+        }
+    }
+
+    void SlicedPopulation::decode(size_t block, bitvector chromosomes[64]) const {
+        for (unsigned int gene = 0; gene < 64; gene++) {
+            chromosomes[gene] = gene < bits ? planes[block * bits + gene] : 0;
+        }
+        transpose64(chromosomes);
+    }
+
+    void SlicedPopulation::mutate(double probability) {
+        size_t genes = planes.size() * 64;
+        if (probability <= 0 || genes == 0) {
+            return;
+        }
+
+        // The gaps between flipped genes follow a geometric distribution.
+        for (uint64_t position = geometric(rng, probability); position < genes;
+             position += geometric(rng, probability) + 1) {
+            planes[position / 64] ^= 1ull << (position % 64);
+        }
+
+        // Keep the unused lanes empty.
+        if (blocks > 0) {
+            for (unsigned int gene = 0; gene < bits; gene++) {
+                planes[(blocks - 1) * bits + gene] &= used_lanes(blocks - 1);
+            }
+        }
+    }
+
+    void SlicedPopulation::uniform_crossover(double probability) {
+        for (size_t block = 0; block + 1 < blocks; block += 2) {
+            uint64_t *a = planes.data() + block * bits;
+            uint64_t *b = planes.data() + (block + 1) * bits;
+
+            // Choose the lanes of the first block that are crossed.
+            uint64_t lanes = random_mask(probability) & used_lanes(block + 1);
+
+            // Pair lane j of the first block with lane j - shift of the second one. If the second block is not full,
+            // the pairs are not shifted, so that no organism is paired with an unused lane.
+            unsigned int shift = used_lanes(block + 1) == ~0ull ? bounded(rng, 64) : 0;
+            for (unsigned int gene = 0; gene < bits; gene++) {
+                uint64_t partner = rotate_left(b[gene], shift);
+                uint64_t swapped = (a[gene] ^ partner) & lanes & random_word();
+                a[gene] ^= swapped;
+                b[gene] = rotate_left(partner ^ swapped, 64 - shift);
+            }
+        }
+    }
+
+    void SlicedPopulation::bit_frequencies(std::vector<size_t> &counts) const {
+        counts.assign(bits, 0);
+        for (size_t block = 0; block < blocks; block++) {
+            for (unsigned int gene = 0; gene < bits; gene++) {
+                counts[gene] += std::bitset<64>(planes[block * bits + gene]).count();
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Created by visan on 5/20/23.
+//
+
+#ifndef GENETICSIMULATION_SLICED_H
+#define GENETICSIMULATION_SLICED_H
+
+#include<cstdint>
+#include<vector>
+#include "defines.h"
+
+namespace GeneticSimulation {
+    /*
+     * Transposes a 64x64 matrix of bits in place: bit j of row i becomes bit i of row j.
+     */
+    void transpose64(uint64_t rows[64]);
+
+    /*
+     * This class stores a population of small chromosomes in a bit-sliced layout: the organisms are grouped
+     * in blocks of 64, and a block is stored as one word per gene, where bit j of the word for gene i is gene i
+     * of organism j of the block (its lane). An operator then processes a gene of 64 organisms at once,
+     * and a chromosome only takes as many bits as its size.
+     */
+    class SlicedPopulation {
+    private:
+        // The size of a chromosome, in bits.
+        unsigned int bits;
+
+        // The number of organisms.
+        size_t size;
+
+        // The number of blocks of 64 organisms. The lanes of the last block past the size are unused.
+        size_t blocks;
+
+        // The gene words: the word for gene i of block b is at index b * bits + i.
+        std::vector<uint64_t> planes;
+
+        /*
+         * Returns the mask of the lanes of the given block that hold organisms.
+         */
+        uint64_t used_lanes(size_t block) const;
+
+    public:
+        SlicedPopulation(unsigned int _bits, size_t _size);
+
+        /*
+         * Generates a population of random organisms.
+         */
+        static SlicedPopulation random_population(unsigned int bits, size_t size);
+
+        /*
+         * Returns the number of organisms.
+         */
+        size_t get_size() const;
+
+        /*
+         * Returns the size of a chromosome, in bits.
+         */
+        unsigned int get_bits() const;
+
+        /*
+         * Returns the chromosome of the organism with the given index.
+         */
+        bitvector get(size_t index) const;
+
+        /*
+         * Sets the chromosome of the organism with the given index.
+         */
+        void set(size_t index, bitvector chromosome);
+
+        /*
+         * Decodes the chromosomes of the 64 organisms of the given block, with the transpose kernel.
+         * The chromosomes of the unused lanes are 0.
+         */
+        void decode(size_t block, bitvector chromosomes[64]) const;
+
+        /*
+         * Flips every gene of every organism independently, with the given probability. The flipped genes
+         * are found by drawing the gaps between them, so the cost is proportional to the number of flips.
+         */
+        void mutate(double probability);
+
+        /*
+         * Uniform cross-over of the organisms of consecutive blocks: every organism of an even block is paired with
+         * an organism of the next block and, with the given probability (rounded to 16 binary digits), every gene
+         * of the pair is swapped with probability 1/2. The pairs are shifted by a random number of lanes, so organisms are not always
+         * paired with the same lane.
+         */
+        void uniform_crossover(double probability);
+
+        /*
+         * Counts how many organisms have every gene set, with one popcount per 64 organisms.
+         */
+        void bit_frequencies(std::vector<size_t> &counts) const;
+    };
+}
+
+#endif //GENETICSIMULATION_SLICED_H
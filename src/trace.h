@@ -0,0 +1,25 @@
+//
+// Created by visan on 5/19/23.
+//
+
+#ifndef GENETICSIMULATION_TRACE_H
+#define GENETICSIMULATION_TRACE_H
+
+namespace GeneticSimulation {
+    /*
+     * Tracing levels of the optimisers. They are template parameters of the stages of an epoch, so the
+     * tracing code is checked with "if constexpr" and the stages are compiled without it when it is disabled.
+     */
+
+    // No tracing, used in the hot loop.
+    struct NoTrace {
+        static constexpr bool enabled = false;
+    };
+
+    // Every step of every stage is printed to the output stream of the optimiser.
+    struct VerboseTrace {
+        static constexpr bool enabled = true;
+    };
+}
+
+#endif //GENETICSIMULATION_TRACE_H
@@ -0,0 +1,32 @@
+//
+// Created by visan on 5/14/23.
+//
+
+#include "workspace.h"
+
+namespace GeneticSimulation {
+    void Workspace::reserve(size_t population_size) {
+        fitness_score.reserve(population_size);
+        violation.reserve(population_size);
+        points.reserve(population_size);
+        values.reserve(population_size);
+        intervals.reserve(population_size);
+        uniforms.reserve(population_size);
+        selected.reserve(population_size);
+        elites.reserve(population_size);
+        pool.reserve(population_size);
+        next_fitness.reserve(population_size);
+        next_violation.reserve(population_size);
+        age.reserve(population_size);
+        positions.reserve(population_size);
+        raw_fitness.reserve(population_size);
+        order.reserve(population_size);
+        position.reserve(population_size);
+        prefix.reserve(population_size + 1);
+        cleared.reserve(population_size);
+        winners.reserve(population_size);
+        cross.reserve(population_size);
+        to_mutate.reserve(population_size);
+        ranking.reserve(population_size);
+    }
+}
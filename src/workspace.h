@@ -0,0 +1,113 @@
+//
+// Created by visan on 5/14/23.
+//
+
+#ifndef GENETICSIMULATION_WORKSPACE_H
+#define GENETICSIMULATION_WORKSPACE_H
+
+#include<vector>
+#include "organism.h"
+
+namespace GeneticSimulation {
+    /*
+     * This struct holds the scratch buffers used by the optimiser while simulating an epoch.
+     * The buffers are sized once, when the optimiser is created, and are then borrowed by every stage
+     * of the pipeline, so that simulating an epoch does not allocate memory in the steady state.
+     */
+    struct Workspace {
+        /*
+         * The fitness score of every organism in the current population.
+         */
+        std::vector<double> fitness_score;
+
+        /*
+         * The number of feasibility checks failed by every organism in the current population.
+         * It is only filled when the problem has constraints.
+         */
+        std::vector<double> violation;
+
+        /*
+         * True if the fitness scores were computed while the current population was formed, so that they do not
+         * have to be computed again.
+         */
+        bool fitness_current = false;
+
+        /*
+         * The decoded organisms sent to the batch evaluator, and the values it returned.
+         */
+        std::vector<double> points;
+        std::vector<double> values;
+
+        /*
+         * Random uniform numbers drawn in bulk by the stages.
+         */
+        std::vector<double> uniforms;
+
+        /*
+         * The probability intervals used by the selection.
+         */
+        std::vector<double> intervals;
+
+        /*
+         * The organisms chosen by the selection. Cross-over and mutation are applied in place on this buffer,
+         * and it becomes the next population at the end of the epoch.
+         */
+        std::vector<Organism> selected;
+
+        /*
+         * The fittest organisms, passed unchanged to the next generation.
+         */
+        std::vector<Organism> elites;
+
+        /*
+         * The parents and the offspring among which the survivors are chosen, and the fitness scores and
+         * violations of the survivors.
+         */
+        std::vector<Organism> pool;
+        std::vector<double> next_fitness;
+        std::vector<double> next_violation;
+
+        /*
+         * The number of generations every organism of the current population has survived.
+         */
+        std::vector<unsigned int> age;
+
+        /*
+         * The decoded organisms and their raw fitness scores, when the scores are shared or cleared.
+         */
+        std::vector<double> positions;
+        std::vector<double> raw_fitness;
+
+        /*
+         * The scratch buffers of the niching: indices of organisms sorted by position, the position of every organism
+         * in the sorted order, prefix sums of the sorted positions, the cleared organisms and the niche winners.
+         */
+        std::vector<size_t> order;
+        std::vector<size_t> position;
+        std::vector<double> prefix;
+        std::vector<char> cleared;
+        std::vector<size_t> winners;
+
+        /*
+         * Indices of organisms that will be crossed-over.
+         */
+        std::vector<size_t> cross;
+
+        /*
+         * Indices of organisms that will be mutated.
+         */
+        std::vector<size_t> to_mutate;
+
+        /*
+         * Indices of organisms, partially ordered by fitness.
+         */
+        std::vector<size_t> ranking;
+
+        /*
+         * Reserves enough memory in every buffer to simulate a population of the given size.
+         */
+        void reserve(size_t population_size);
+    };
+}
+
+#endif //GENETICSIMULATION_WORKSPACE_H
@@ -0,0 +1,120 @@
+//
+// Created by visan on 5/14/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+TEST_CASE("One fifth rule", "[adaptive]") {
+    OneFifthRule rule(5, 2, 0.001, 0.5);
+    double cross = 0.25, mutation = 0.01;
+    epoch_stats stats{0, 0, 0, 0, 0, cross, mutation};
+
+    SECTION("Successful window") {
+        // Every epoch improves the best fitness.
+        for (unsigned int e = 0; e < 5; e++) {
+            stats.max_fitness = e + 1;
+            rule.update(stats, cross, mutation);
+        }
+        REQUIRE_THAT(mutation, Catch::Matchers::WithinAbs(0.02, 1e-12));
+        REQUIRE(cross == 0.25);
+    }
+
+    SECTION("Unsuccessful window") {
+        // Only the first epoch improves the best fitness.
+        stats.max_fitness = 1;
+        for (unsigned int e = 0; e < 5; e++) {
+            rule.update(stats, cross, mutation);
+        }
+        REQUIRE_THAT(mutation, Catch::Matchers::WithinAbs(0.005, 1e-12));
+    }
+}
+
+TEST_CASE("Diversity control", "[adaptive]") {
+    DiversityControl control(0.2, 0.1);
+    double cross = 0.25, mutation = 0.01;
+    epoch_stats stats{0, 0, 0, 0, 0, cross, mutation};
+
+    SECTION("Converged population") {
+        stats.diversity = 0;
+        control.update(stats, cross, mutation);
+        REQUIRE(mutation > 0.01);
+        REQUIRE(cross < 0.25);
+    }
+
+    SECTION("Diverse population") {
+        stats.diversity = 0.8;
+        control.update(stats, cross, mutation);
+        REQUIRE(mutation < 0.01);
+        REQUIRE(cross > 0.25);
+    }
+
+    SECTION("On target") {
+        stats.diversity = 0.2;
+        control.update(stats, cross, mutation);
+        REQUIRE_THAT(mutation, Catch::Matchers::WithinAbs(0.01, 1e-12));
+        REQUIRE_THAT(cross, Catch::Matchers::WithinAbs(0.25, 1e-12));
+    }
+}
+
+TEST_CASE("Population diversity", "[adaptive]") {
+    Optimiser opt(parabola, 2, {0, 1}, 1, 0.25, 0.01, 1);
+    std::vector<Organism> same = {Organism(0b0101, 4), Organism(0b0101, 4)};
+    std::vector<Organism> opposite = {Organism(0b0101, 4), Organism(0b1010, 4)};
+    std::vector<Organism> half = {Organism(0b0011, 4), Organism(0b0000, 4)};
+    REQUIRE(opt.diversity(same) == 0);
+    REQUIRE(opt.diversity(opposite) == 1);
+    REQUIRE(opt.diversity(half) == 0.5);
+}
+
+TEST_CASE("Rate trajectories are recorded", "[adaptive]") {
+    rng.seed(7);
+    Optimiser opt(parabola, 4, {-1, 2}, 2, 0.25, 0.01, 20);
+    opt.set_telemetry(true);
+    opt.set_rate_controller(std::make_unique<DiversityControl>(0.5, 0.5));
+    opt.optimise();
+
+    const std::vector<epoch_stats> &telemetry = opt.get_telemetry();
+    REQUIRE(telemetry.size() == 20);
+    for (unsigned int e = 0; e < telemetry.size(); e++) {
+        REQUIRE(telemetry[e].epoch == e);
+        REQUIRE(telemetry[e].mutation_probability > 0);
+    }
+    // The probabilities change as the population evolves.
+    REQUIRE(telemetry.front().mutation_probability != telemetry.back().mutation_probability);
+    REQUIRE(opt.get_evaluations() >= 20 * 4);
+}
+
+TEST_CASE("Every run starts from the configured rates", "[adaptive]") {
+    for (int controller = 0; controller < 2; controller++) {
+        Optimiser opt(parabola, 10, {-1, 2}, 6, 0.25, 0.01, 50);
+        opt.set_output(nullptr);
+        opt.set_telemetry(true);
+        if (controller == 0) {
+            opt.set_rate_controller(std::make_unique<OneFifthRule>(5));
+        } else {
+            opt.set_rate_controller(std::make_unique<DiversityControl>(0.5, 0.5));
+        }
+
+        rng.seed(11);
+        opt.optimise();
+        std::vector<epoch_stats> first = opt.get_telemetry();
+        rng.seed(11);
+        opt.optimise();
+        const std::vector<epoch_stats> &second = opt.get_telemetry();
+
+        // With the same seed, the second run repeats the first one.
+        REQUIRE(second.size() == first.size());
+        for (size_t e = 0; e < first.size(); e++) {
+            REQUIRE(second[e].cross_probability == first[e].cross_probability);
+            REQUIRE(second[e].mutation_probability == first[e].mutation_probability);
+            REQUIRE(second[e].max_fitness == first[e].max_fitness);
+        }
+    }
+}
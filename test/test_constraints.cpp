@@ -0,0 +1,127 @@
+//
+// Created by visan on 5/17/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+// The number of times the objective was called outside the feasible region [-1, 0.25].
+static unsigned int infeasible_calls = 0;
+
+static double objective(double x) {
+    if (x < -1 || x > 0.25) {
+        infeasible_calls++;
+    }
+    return -x * x + x + 2;
+}
+
+static bool feasible(double x) {
+    return x <= 0.25;
+}
+
+TEST_CASE("Constraint checks", "[constraints]") {
+    Constraints constraints;
+    REQUIRE(constraints.empty());
+
+    constraints.add_predicate(feasible);
+    constraints.add_predicate([](double x) { return x >= 0; });
+    constraints.add_penalty([](double x) { return x - 0.1; }, 10);
+    REQUIRE_FALSE(constraints.empty());
+
+    REQUIRE(constraints.failed_predicates(0.1) == 0);
+    REQUIRE(constraints.failed_predicates(0.5) == 1);
+    REQUIRE(constraints.failed_predicates(-0.5) == 1);
+    REQUIRE(constraints.penalty(0.05) == 0);
+    REQUIRE_THAT(constraints.penalty(0.2), Catch::Matchers::WithinAbs(1, 1e-12));
+    REQUIRE_FALSE(constraints.can_repair());
+}
+
+TEST_CASE("Domain round trip", "[constraints]") {
+    Optimiser opt(objective, 20, {-1, 2}, 6, 0.25, 0.01, 50);
+    Organism organism(0b0000011101001001110001, 22);
+    REQUIRE(opt.from_domain(opt.to_domain(organism)).get_chromosome() == organism.get_chromosome());
+    REQUIRE(opt.from_domain(-5).get_chromosome() == 0);
+    REQUIRE(opt.from_domain(5).get_chromosome() == (1 << 22) - 1);
+}
+
+TEST_CASE("Infeasible organisms are rejected before evaluation", "[constraints]") {
+    // The unconstrained maximum is at 0.5, outside of the feasible region.
+    Optimiser opt(objective, 20, {-1, 2}, 4, 0.25, 0.05, 300);
+    Constraints constraints;
+    constraints.add_predicate(feasible);
+    opt.set_constraints(constraints);
+    // The local search must not leave the feasible region either.
+    opt.set_memetic(1, 10);
+
+    rng.seed(2);
+    infeasible_calls = 0;
+    double x = opt.optimise();
+
+    REQUIRE(infeasible_calls == 0);
+    REQUIRE(opt.get_saved_evaluations() > 0);
+    REQUIRE(x <= 0.25);
+    REQUIRE_THAT(x, Catch::Matchers::WithinAbs(0.25, 0.01));
+}
+
+TEST_CASE("Infeasible organisms are repaired", "[constraints]") {
+    Optimiser opt(objective, 20, {-1, 2}, 4, 0.25, 0.05, 100);
+    Constraints constraints;
+    constraints.add_predicate(feasible);
+    constraints.set_repair([](double x) { return std::min(x, 0.25); });
+    opt.set_constraints(constraints);
+
+    rng.seed(2);
+    infeasible_calls = 0;
+    double x = opt.optimise();
+
+    REQUIRE(infeasible_calls == 0);
+    REQUIRE(opt.get_repairs() > 0);
+    REQUIRE(opt.get_saved_evaluations() == 0);
+    REQUIRE_THAT(x, Catch::Matchers::WithinAbs(0.25, 0.001));
+}
+
+TEST_CASE("Penalties move the maximum", "[constraints]") {
+    Optimiser opt(objective, 20, {-1, 2}, 4, 0.25, 0.05, 300);
+    Constraints constraints;
+    constraints.add_penalty([](double x) { return x - 0.25; }, 100);
+    opt.set_constraints(constraints);
+    opt.set_memetic(1, 10);
+
+    rng.seed(2);
+    double x = opt.optimise();
+
+    REQUIRE(opt.get_saved_evaluations() == 0);
+    REQUIRE_THAT(x, Catch::Matchers::WithinAbs(0.25, 0.01));
+}
+
+// Flat on [-1, -0.6], so that the local search cannot improve a point there, and increasing above.
+static double plateau(double x) {
+    return x <= -0.6 ? 1 : 2 + x;
+}
+
+TEST_CASE("The local search updates the feasibility", "[constraints]") {
+    for (unsigned int seed = 0; seed < 50; seed++) {
+        Optimiser opt(plateau, 2, {-1, 2}, 6, 0, 0, 1);
+        Constraints constraints;
+        constraints.add_predicate([](double x) {
+            return x <= -0.6 || (x >= -0.1 && x <= 0.25);
+        });
+        opt.set_constraints(constraints);
+        opt.set_memetic(2);
+
+        // A feasible organism that the local search cannot improve, and an infeasible one that it makes feasible
+        // and fitter. The latter must be kept as the elite.
+        std::vector<Organism> population = {opt.from_domain(-0.9), opt.from_domain(0.3)};
+        rng.seed(seed);
+        opt.evolve(population);
+
+        bool kept = false;
+        for (const Organism &o: population) {
+            double x = opt.to_domain(o);
+            kept = kept || (x >= -0.1 && x <= 0.25);
+        }
+        REQUIRE(kept);
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Created by visan on 5/26/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include<cmath>
+#include<limits>
+#include<sstream>
+#include "../src/convergence.h"
+#include "../src/objectives.h"
+
+using namespace GeneticSimulation;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("Confidence intervals", "[convergence]") {
+    estimate mean = mean_estimate({1, 2, 3, 4, 5});
+    REQUIRE(mean.mean == 3);
+    // The standard error is sqrt(2.5 / 5).
+    REQUIRE_THAT(mean.low, WithinAbs(3 - 1.959964 * std::sqrt(0.5), 1e-6));
+    REQUIRE_THAT(mean.high, WithinAbs(3 + 1.959964 * std::sqrt(0.5), 1e-6));
+
+    estimate single = mean_estimate({7});
+    REQUIRE(single.low == 7);
+    REQUIRE(single.high == 7);
+
+    // The Wilson score interval of 8 successes out of 10.
+    estimate proportion = proportion_estimate(8, 10);
+    REQUIRE(proportion.mean == 0.8);
+    REQUIRE_THAT(proportion.low, WithinAbs(0.4902, 1e-4));
+    REQUIRE_THAT(proportion.high, WithinAbs(0.9433, 1e-4));
+
+    estimate none = proportion_estimate(0, 20);
+    REQUIRE(none.low == 0);
+    REQUIRE(none.high > 0);
+}
+
+TEST_CASE("Measuring the convergence", "[convergence]") {
+    const objective &o = find_objective("parabola");
+    job configuration{0, o.name, 20, o.domain, 4, 0.25, 0.05, 500, 1, 0, 2.2499, 1};
+    convergence_stats stats = measure_convergence(configuration, 20, 2);
+
+    REQUIRE(stats.objective == "parabola");
+    REQUIRE(stats.runs == 20);
+    REQUIRE(stats.success_rate.mean > 0.5);
+    REQUIRE(stats.evaluations.mean > 20);
+    REQUIRE(stats.evaluations.low <= stats.evaluations.mean);
+
+    // The runs are seeded, so the statistics can be reproduced.
+    convergence_stats again = measure_convergence(configuration, 20, 1);
+    REQUIRE(again.success_rate.mean == stats.success_rate.mean);
+    REQUIRE(again.evaluations.mean == stats.evaluations.mean);
+}
+
+TEST_CASE("Baselines and regressions", "[convergence]") {
+    convergence_stats baseline{"g", 100, {0.6, 0.5, 0.7}, {1000, 900, 1100}, {0.01, 0.009, 0.011}};
+    std::stringstream stream;
+    save_baseline(stream, {baseline});
+    std::vector<convergence_stats> loaded = load_baseline(stream);
+    REQUIRE(loaded.size() == 1);
+    REQUIRE(loaded[0].objective == "g");
+    REQUIRE(loaded[0].runs == 100);
+    REQUIRE(loaded[0].evaluations.high == 1100);
+
+    // Within the tolerance, or not significantly worse.
+    convergence_stats current{"g", 100, {0.55, 0.45, 0.65}, {1150, 1050, 1250}, {0.02, 0.015, 0.025}};
+    REQUIRE(find_regressions(current, baseline, 0.1, 2).empty());
+
+    convergence_stats worse{"g", 100, {0.3, 0.2, 0.4}, {1500, 1300, 1700}, {0.05, 0.04, 0.06}};
+    REQUIRE(find_regressions(worse, baseline, 0.1, 2).size() == 3);
+    REQUIRE(find_regressions(worse, baseline, 0.1, std::numeric_limits<double>::infinity()).size() == 2);
+
+    std::stringstream malformed("g 100 0.5\n");
+    REQUIRE_THROWS_AS(load_baseline(malformed), std::runtime_error);
+}
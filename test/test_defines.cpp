@@ -34,4 +34,26 @@ TEST_CASE("Test bitvector to string") {
     REQUIRE(GeneticSimulation::bitvector_to_string(a, 12) == "001010111011");
     REQUIRE(GeneticSimulation::bitvector_to_string(b, 1) == "1");
     REQUIRE(GeneticSimulation::bitvector_to_string(c, 19) == "0010111101010010101");
-}
\ No newline at end of file
+}
+TEST_CASE("Test wide random bitvectors", "[util]") {
+    GeneticSimulation::rng.seed(1);
+    GeneticSimulation::bitvector all = 0;
+    for (int i = 0; i < 100; i++) {
+        GeneticSimulation::bitvector vector = GeneticSimulation::random_bitvector(40);
+        REQUIRE(vector < ((GeneticSimulation::bitvector) 1 << 40));
+        all |= vector;
+        all |= GeneticSimulation::random_bitvector(64);
+    }
+    REQUIRE(all == ~(GeneticSimulation::bitvector) 0);
+    REQUIRE(GeneticSimulation::bitvector_to_string((GeneticSimulation::bitvector) 1 << 40, 41).front() == '1');
+}
+
+TEST_CASE("Chromosome encoding", "[util]") {
+    // 3 * 10^6 points need 22 bits.
+    REQUIRE(GeneticSimulation::chromosome_bits({-1, 2}, 6) == 22);
+    REQUIRE(GeneticSimulation::chromosome_bits({0, 1}, 1) == 4);
+    double step = GeneticSimulation::discrete_step({-1, 2}, 22);
+    REQUIRE(step == 3.0 / (1 << 22));
+    REQUIRE(GeneticSimulation::decode_chromosome(0, {-1, 2}, step) == -1);
+    REQUIRE(GeneticSimulation::decode_chromosome(1 << 21, {-1, 2}, step) == 0.5);
+}
@@ -0,0 +1,79 @@
+//
+// Created by visan on 5/19/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include<sstream>
+#include "../src/engine.h"
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+TEST_CASE("Engine matches the runtime optimiser", "[engine]") {
+    Optimiser opt(parabola, 30, {-1, 2}, 6, 0.25, 0.01, 200);
+    REQUIRE(opt.get_bits_per_chromosome() == 22);
+    Engine<uint32_t, 22> engine(parabola, 30, {-1, 2}, 0.25, 0.01);
+
+    // With the same seed and the default policies, both draw the same random numbers.
+    rng.seed(9);
+    double expected = opt.optimise();
+    rng.seed(9);
+    REQUIRE(engine.run(200) == expected);
+}
+
+TEST_CASE("Engine with other policies", "[engine]") {
+    auto objective = [](double x) {
+        return -x * x + x + 2;
+    };
+    Engine<uint16_t, 12, TournamentSelection, UniformCrossover, BitFlipMutation, NoTrace, decltype(objective)>
+            engine(objective, 40, {-1, 2}, 0.6, 0.1);
+
+    rng.seed(10);
+    double x = engine.run(300);
+    REQUIRE_THAT(x, Catch::Matchers::WithinAbs(0.5, 0.01));
+    REQUIRE(engine.get_population().size() == 40);
+    for (uint16_t chromosome: engine.get_population()) {
+        REQUIRE(chromosome < (1 << 12));
+    }
+}
+
+TEST_CASE("Single point cross-over", "[engine]") {
+    // The same chromosomes as in the organism tests.
+    uint16_t a = 0b010110110101, b = 0b110010101100;
+    SinglePointCrossover::cross<uint16_t, NoTrace>(a, b, 4, std::cout);
+    REQUIRE(a == 0b110010110101);
+    REQUIRE(b == 0b010110101100);
+
+    uint8_t c = 0b10101010, d = 0b01010101;
+    SinglePointCrossover::cross<uint8_t, NoTrace>(c, d, 7, std::cout);
+    REQUIRE(c == 0b10101010);
+    REQUIRE(d == 0b01010101);
+}
+
+TEST_CASE("Engine with wide chromosomes", "[engine]") {
+    Engine<uint64_t, 40> engine(parabola, 30, {-1, 2}, 0.25, 0.05);
+    rng.seed(12);
+    double x = engine.run(300);
+    REQUIRE_THAT(x, Catch::Matchers::WithinAbs(0.5, 0.05));
+    // Some chromosome uses the genes above the 32nd one, and none uses the genes above the 40th one.
+    bool high = false;
+    for (uint64_t chromosome: engine.get_population()) {
+        REQUIRE(chromosome < ((uint64_t) 1 << 40));
+        high = high || chromosome >= ((uint64_t) 1 << 32);
+    }
+    REQUIRE(high);
+}
+
+TEST_CASE("Engine trace goes to its output", "[engine]") {
+    Engine<uint16_t, 12, RouletteSelection, SinglePointCrossover, BitFlipMutation, VerboseTrace> engine(
+            parabola, 10, {-1, 2}, 0.5, 0.5);
+    std::ostringstream trace;
+    engine.set_output(&trace);
+    rng.seed(13);
+    engine.run(1);
+    REQUIRE(trace.str().find("After mutation") != std::string::npos);
+}
@@ -0,0 +1,175 @@
+//
+// Created by visan on 5/25/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include<algorithm>
+#include<sstream>
+#include "../src/experiment.h"
+#include "../src/objectives.h"
+
+using namespace GeneticSimulation;
+
+TEST_CASE("Objective registry", "[experiment]") {
+    REQUIRE(objectives().size() == 6);
+    REQUIRE_THAT(find_objective("rastrigin").function(0), Catch::Matchers::WithinAbs(50, 1e-12));
+    REQUIRE_THAT(find_objective("ackley").function(0), Catch::Matchers::WithinAbs(25, 1e-12));
+    REQUIRE_THAT(find_objective("schwefel").function(420.9687), Catch::Matchers::WithinAbs(1000, 1e-3));
+    REQUIRE(find_objective("g").domain.left == -2);
+    REQUIRE_THROWS_AS(find_objective("h"), std::invalid_argument);
+}
+
+TEST_CASE("Configuration", "[experiment]") {
+    Experiment experiment;
+    std::istringstream config("# A small sweep.\n"
+                              "objective = parabola, rastrigin\n"
+                              "\n"
+                              "mutation = 0.01, 0.05, 0.1  # three rates\n"
+                              "runs = 2\n"
+                              "seed = 7\n"
+                              "format = json\n");
+    experiment.load(config);
+    experiment.set("left", "-3");
+
+    std::vector<job> jobs = experiment.jobs();
+    REQUIRE(jobs.size() == 2 * 3 * 2);
+    REQUIRE(experiment.format() == "json");
+    REQUIRE(experiment.summary() == "-");
+
+    // The last parameter changes fastest, and the runs of a combination are consecutive.
+    REQUIRE(jobs[0].objective == "parabola");
+    REQUIRE(jobs[0].mutation_probability == 0.01);
+    REQUIRE(jobs[0].seed == 7);
+    REQUIRE(jobs[1].seed == 8);
+    REQUIRE(jobs[2].mutation_probability == 0.05);
+    REQUIRE(jobs[6].objective == "rastrigin");
+    for (size_t i = 0; i < jobs.size(); i++) {
+        REQUIRE(jobs[i].index == i);
+        REQUIRE(jobs[i].domain.left == -3);
+        REQUIRE(jobs[i].population_size == 10);
+    }
+    REQUIRE(jobs[0].domain.right == 2);
+    REQUIRE(jobs[6].domain.right == 5.12);
+
+    REQUIRE_THROWS_AS(experiment.set("populaton", "10"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("population", "ten"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("objective", "parabola, h"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("format", "xml"), std::invalid_argument);
+    std::istringstream invalid("population 10\n");
+    REQUIRE_THROWS_AS(experiment.load(invalid), std::invalid_argument);
+}
+
+TEST_CASE("Parallel runs do not depend on the number of threads", "[experiment]") {
+    Experiment experiment;
+    experiment.set("objective", "parabola, g");
+    experiment.set("population", "10, 20");
+    experiment.set("epochs", "200");
+    experiment.set("runs", "3");
+    std::vector<job> jobs = experiment.jobs();
+
+    std::vector<job_result> serial = run_jobs(jobs, 1);
+    std::vector<job_result> parallel = run_jobs(jobs, 4);
+    REQUIRE(parallel.size() == jobs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        REQUIRE(parallel[i].configuration.index == i);
+        REQUIRE(parallel[i].x == serial[i].x);
+        REQUIRE(parallel[i].evaluations == serial[i].evaluations);
+    }
+    REQUIRE_THAT(serial[0].fitness, Catch::Matchers::WithinAbs(2.25, 0.1));
+}
+
+TEST_CASE("Summary", "[experiment]") {
+    Experiment experiment;
+    experiment.set("objective", "parabola");
+    experiment.set("epochs", "10");
+    experiment.set("runs", "2");
+    std::vector<job_result> results = run_jobs(experiment.jobs(), 2);
+
+    std::ostringstream csv;
+    write_summary(csv, results, "csv");
+    std::string text = csv.str();
+    REQUIRE(text.rfind("job,objective,population,", 0) == 0);
+    REQUIRE(std::count(text.begin(), text.end(), '\n') == 3);
+    REQUIRE(text.find("\n1,parabola,10,") != std::string::npos);
+
+    std::ostringstream json;
+    write_summary(json, results, "json");
+    text = json.str();
+    REQUIRE(text.front() == '[');
+    REQUIRE(text.find("\"target\": null") != std::string::npos);
+    REQUIRE(std::count(text.begin(), text.end(), '{') == 2);
+}
+
+TEST_CASE("Invalid settings are rejected", "[experiment]") {
+    Experiment experiment;
+    REQUIRE_THROWS_AS(experiment.set("population", "0"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("population", "1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("precision", "11"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("cross", "0.2, 1.5"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("mutation", "-0.1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("left", "inf"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("radius", "0"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("replacement", "steady"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("population", "4294967296"), std::invalid_argument);
+    REQUIRE_THROWS_AS(experiment.set("epochs", "99999999999"), std::invalid_argument);
+
+    // The domain is checked when the jobs are created, since left and right are set separately.
+    experiment.set("left", "3");
+    experiment.set("right", "1");
+    REQUIRE_THROWS_AS(experiment.jobs(), std::invalid_argument);
+    experiment.set("right", "3");
+    REQUIRE_THROWS_AS(experiment.jobs(), std::invalid_argument);
+    experiment.set("left", "-500");
+    experiment.set("right", "500");
+    experiment.set("precision", "7");
+    REQUIRE_THROWS_AS(experiment.jobs(), std::invalid_argument);
+    experiment.set("precision", "6");
+    REQUIRE(experiment.jobs().size() == 1);
+
+    // The runs of two seeds of the grid must not overlap.
+    experiment.set("runs", "2");
+    experiment.set("seed", "1, 2");
+    REQUIRE_THROWS_AS(experiment.jobs(), std::invalid_argument);
+    experiment.set("seed", "1, 3");
+    std::vector<job> jobs = experiment.jobs();
+    REQUIRE(jobs.size() == 4);
+    REQUIRE(jobs[3].seed == 4);
+    experiment.set("seed", "1");
+
+    // A file reports the line of the bad setting.
+    std::istringstream config("objective = parabola\n"
+                              "\n"
+                              "population = 0\n");
+    try {
+        experiment.load(config);
+        FAIL("The population was accepted");
+    } catch (const std::invalid_argument &error) {
+        std::string message = error.what();
+        REQUIRE(message.find("Line 3") != std::string::npos);
+        REQUIRE(message.find("population") != std::string::npos);
+    }
+}
+
+TEST_CASE("Replacement, niching and rates in the grid", "[experiment]") {
+    Experiment experiment;
+    experiment.set("objective", "parabola");
+    experiment.set("epochs", "50");
+    experiment.set("replacement", "generational, plus, comma, age");
+    experiment.set("lambda", "0, 5");
+    experiment.set("niching", "none, sharing, clearing, crowding");
+    experiment.set("radius", "0.2");
+    experiment.set("rates", "fixed, one_fifth, diversity");
+    std::vector<job> jobs = experiment.jobs();
+    REQUIRE(jobs.size() == 4 * 2 * 4 * 3);
+    REQUIRE(jobs[0].replacement == "generational");
+    REQUIRE(jobs[1].rates == "one_fifth");
+    REQUIRE(jobs.back().niching == "crowding");
+    REQUIRE(jobs.back().radius == 0.2);
+
+    std::vector<job_result> results = run_jobs(jobs, 0);
+    for (const job_result &r: results) {
+        REQUIRE(r.x >= -1);
+        REQUIRE(r.x <= 2);
+        REQUIRE(r.evaluations > 0);
+    }
+}
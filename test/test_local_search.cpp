@@ -0,0 +1,63 @@
+//
+// Created by visan on 5/15/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+static double g(double x) {
+    double c = cos(x * x + x + 7);
+    double s = sin(x + 10);
+    return c * c - s + 5;
+}
+
+TEST_CASE("Hill climb crosses a Hamming cliff", "[local_search]") {
+    // The fitness is highest at 1000, while the organism starts at 0111.
+    std::function<double(const Organism &)> evaluate = [](const Organism &o) {
+        double x = (double) o.get_chromosome();
+        return 100 - (x - 8) * (x - 8);
+    };
+    Organism organism(0b0111, 4);
+    double fitness = hill_climb(organism, evaluate(organism), evaluate, 4);
+    REQUIRE(organism.get_chromosome() == 0b1000);
+    REQUIRE(fitness == 100);
+}
+
+TEST_CASE("Hill climb stays at the maximum", "[local_search]") {
+    unsigned int calls = 0;
+    std::function<double(const Organism &)> evaluate = [&calls](const Organism &o) {
+        calls++;
+        double x = (double) o.get_chromosome();
+        return 100 - (x - 5) * (x - 5);
+    };
+    Organism organism(5, 4);
+    double fitness = hill_climb(organism, 100, evaluate, 4);
+    REQUIRE(organism.get_chromosome() == 5);
+    REQUIRE(fitness == 100);
+    // A single pass that does not improve the organism.
+    REQUIRE(calls <= 8);
+}
+
+TEST_CASE("Memetic stage needs fewer evaluations than the pure GA", "[local_search]") {
+    Optimiser pure(g, 10, {-2, 4}, 6, 0.25, 0.01, 2000);
+    Optimiser memetic(g, 10, {-2, 4}, 6, 0.25, 0.01, 2000);
+    memetic.set_memetic(1, 10);
+
+    // The best fitness that can be represented with this precision.
+    double best = 0;
+    unsigned int bits = pure.get_bits_per_chromosome();
+    for (bitvector chromosome = 0; chromosome < ((bitvector) 1 << bits); chromosome++) {
+        best = std::max(best, g(pure.to_domain(Organism(chromosome, bits))));
+    }
+    pure.set_target_fitness(best - 1e-9);
+    memetic.set_target_fitness(best - 1e-9);
+
+    rng.seed(1);
+    pure.optimise();
+    rng.seed(1);
+    double x = memetic.optimise();
+
+    REQUIRE(g(x) >= best - 1e-9);
+    REQUIRE(memetic.get_evaluations() * 100 < pure.get_evaluations());
+}
@@ -0,0 +1,106 @@
+//
+// Created by visan on 5/23/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include<algorithm>
+#include<cmath>
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+// Five peaks of equal height, at 0.1, 0.3, 0.5, 0.7 and 0.9.
+static double peaks(double x) {
+    return std::pow(std::sin(5 * M_PI * x), 6);
+}
+
+// The niche count of every point, computed naively.
+static std::vector<double> naive_shared(const std::vector<double> &points, const std::vector<double> &fitness,
+                                        double radius, double alpha) {
+    std::vector<double> result;
+    for (size_t i = 0; i < points.size(); i++) {
+        double count = 0;
+        for (double y: points) {
+            double d = std::abs(points[i] - y);
+            if (d < radius) {
+                count += 1 - std::pow(d / radius, alpha);
+            }
+        }
+        result.push_back(fitness[i] / count);
+    }
+    return result;
+}
+
+// Returns true if every peak has a point within the given distance.
+static bool finds_all_peaks(const std::vector<double> &optima, double distance) {
+    for (double peak: {0.1, 0.3, 0.5, 0.7, 0.9}) {
+        bool found = std::any_of(optima.begin(), optima.end(), [peak, distance](double x) {
+            return std::abs(x - peak) < distance;
+        });
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Fitness sharing", "[niching]") {
+    rng.seed(21);
+    std::vector<double> points(500), fitness(500);
+    fill_uniform(rng, points.data(), points.size());
+    fill_uniform(rng, fitness.data(), fitness.size());
+    // Some points share the same position.
+    points[1] = points[0];
+    points[2] = points[0];
+
+    std::vector<size_t> order;
+    std::vector<double> prefix;
+    for (double alpha: {1.0, 2.0}) {
+        std::vector<double> shared = fitness;
+        share_fitness(points, shared, 0.05, alpha, order, prefix);
+        std::vector<double> expected = naive_shared(points, fitness, 0.05, alpha);
+        for (size_t i = 0; i < points.size(); i++) {
+            REQUIRE_THAT(shared[i], Catch::Matchers::WithinAbs(expected[i], 1e-9));
+        }
+    }
+}
+
+TEST_CASE("Niche winners", "[niching]") {
+    std::vector<double> points = {0.0, 0.05, 0.5, 0.16, 0.55, 0.9, 0.31};
+    std::vector<double> fitness = {1.0, 3.0, 2.0, 0.5, 2.5, 0.1, 0.2};
+    std::vector<size_t> winners, order, position;
+    std::vector<char> cleared;
+    niche_winners(points, fitness, 0.1, winners, order, position, cleared);
+
+    // 0.05 clears 0.0 and 0.16 is too far, 0.55 clears 0.5.
+    std::vector<size_t> expected = {1, 4, 3, 6, 5};
+    REQUIRE(winners == expected);
+}
+
+TEST_CASE("Niche radius must be positive", "[niching]") {
+    REQUIRE_THROWS_AS(Niching::sharing(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(Niching::sharing(0.1, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(Niching::clearing(-0.1), std::invalid_argument);
+    REQUIRE_THROWS_AS(Niching::crowding(std::nan("")), std::invalid_argument);
+    REQUIRE(Niching::clearing(0.1).get_radius() == 0.1);
+}
+
+TEST_CASE("Niching finds several optima", "[niching]") {
+    for (Niching niching: {Niching::sharing(0.1), Niching::clearing(0.1), Niching::crowding(0.1)}) {
+        rng.seed(22);
+        Optimiser opt(peaks, 100, {0, 1}, 4, 0.8, 0.1, 100);
+        opt.set_niching(niching);
+        opt.optimise();
+
+        const std::vector<double> &optima = opt.get_optima();
+        REQUIRE(optima.size() >= 5);
+        REQUIRE(finds_all_peaks(optima, 0.02));
+    }
+}
+
+TEST_CASE("Without niching the population collapses", "[niching]") {
+    rng.seed(22);
+    Optimiser opt(peaks, 100, {0, 1}, 4, 0.8, 0.1, 100);
+    opt.optimise();
+    REQUIRE(opt.get_optima().size() == 1);
+}
@@ -3,6 +3,7 @@
 //
 #include<catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include<sstream>
 #include "../src/optimiser.h"
 
 #define private public
@@ -47,3 +48,40 @@ TEST_CASE("Chromosome fitness", "[optimiser]") {
     REQUIRE_THAT(0.133367231, Catch::Matchers::WithinAbs(b.fitness(ord), 0.00001));
 }
 
+
+TEST_CASE("Evaluations are counted per run", "[optimiser]") {
+    rng.seed(3);
+    Optimiser a(f, 10, {-1, 2}, 3, 0.25, 0.01, 50);
+    a.set_output(nullptr);
+    // Every epoch evaluates the population once, and the final population is evaluated once more.
+    a.optimise();
+    REQUIRE(a.get_evaluations() == 51 * 10);
+    a.optimise();
+    REQUIRE(a.get_evaluations() == 51 * 10);
+
+    std::ostringstream trace;
+    a.set_output(&trace);
+    a.optimise();
+    // The verbose trace of the first epoch does not count as evaluations.
+    REQUIRE(!trace.str().empty());
+    REQUIRE(a.get_evaluations() == 51 * 10);
+}
+
+TEST_CASE("Evaluations stop when the target is reached", "[optimiser]") {
+    rng.seed(4);
+    Optimiser opt(f, 10, {-1, 2}, 3, 0.25, 0.05, 1000);
+    opt.set_target_fitness(2.249);
+    std::ostringstream trace;
+    opt.set_output(&trace);
+    opt.optimise();
+
+    // The count reported when the target is reached is the count of the whole run.
+    std::string text = trace.str();
+    size_t position = text.find("Target fitness reached after ");
+    REQUIRE(position != std::string::npos);
+    std::istringstream reached(text.substr(position + std::string("Target fitness reached after ").size()));
+    unsigned long long evaluations;
+    reached >> evaluations;
+    REQUIRE(opt.get_evaluations() == evaluations);
+    REQUIRE(evaluations < 1000 * 10);
+}
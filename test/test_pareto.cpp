@@ -0,0 +1,164 @@
+//
+// Created by visan on 5/16/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include<limits>
+#include "../src/multi_optimiser.h"
+
+using namespace GeneticSimulation;
+
+/*
+ * Computes the rank of every point by peeling the non-dominated points, in O(n^3).
+ */
+static std::vector<unsigned int> brute_force_rank(const std::vector<objective_vector> &points, unsigned int m) {
+    std::vector<unsigned int> rank(points.size(), 0);
+    std::vector<bool> removed(points.size(), false);
+    size_t remaining = points.size();
+    for (unsigned int front = 0; remaining > 0; front++) {
+        std::vector<size_t> current;
+        for (size_t i = 0; i < points.size(); i++) {
+            if (removed[i]) {
+                continue;
+            }
+            bool dominated = false;
+            for (size_t j = 0; j < points.size() && !dominated; j++) {
+                dominated = !removed[j] && dominates(points[j], points[i], m);
+            }
+            if (!dominated) {
+                current.push_back(i);
+            }
+        }
+        for (size_t i: current) {
+            rank[i] = front;
+            removed[i] = true;
+            remaining--;
+        }
+    }
+    return rank;
+}
+
+TEST_CASE("Dominance", "[pareto]") {
+    REQUIRE(dominates({2, 2, 0}, {1, 2, 0}, 2));
+    REQUIRE_FALSE(dominates({1, 2, 0}, {1, 2, 0}, 2));
+    REQUIRE_FALSE(dominates({2, 1, 0}, {1, 2, 0}, 2));
+    // Only the first objectives are compared.
+    REQUIRE(dominates({2, 2, 0}, {1, 2, 5}, 2));
+    REQUIRE_FALSE(dominates({2, 2, 0}, {1, 2, 5}, 3));
+}
+
+TEST_CASE("Non-dominated sort matches brute force", "[pareto]") {
+    rng.seed(3);
+    // Use few distinct values, so there are many ties and duplicates.
+    std::uniform_int_distribution<int> dist(0, 9);
+    for (unsigned int m = 1; m <= 3; m++) {
+        std::vector<objective_vector> points(300);
+        for (objective_vector &point: points) {
+            point = {(double) dist(rng), (double) dist(rng), (double) dist(rng)};
+        }
+
+        std::vector<std::vector<size_t>> fronts;
+        std::vector<unsigned int> rank;
+        std::vector<size_t> order;
+        std::vector<staircase> staircases;
+        non_dominated_sort(points, m, fronts, rank, order, staircases);
+        REQUIRE(rank == brute_force_rank(points, m));
+
+        size_t total = 0;
+        for (size_t f = 0; f < fronts.size(); f++) {
+            for (size_t index: fronts[f]) {
+                REQUIRE(rank[index] == f);
+            }
+            total += fronts[f].size();
+        }
+        REQUIRE(total == points.size());
+    }
+}
+
+TEST_CASE("Non-dominated sort scales to large populations", "[pareto]") {
+    rng.seed(5);
+    std::uniform_real_distribution<double> dist(0, 1);
+    std::vector<objective_vector> points(100000);
+    for (objective_vector &point: points) {
+        point = {dist(rng), dist(rng), dist(rng)};
+    }
+    std::vector<std::vector<size_t>> fronts;
+    std::vector<unsigned int> rank;
+    std::vector<size_t> order;
+    std::vector<staircase> staircases;
+    for (unsigned int m = 2; m <= 3; m++) {
+        non_dominated_sort(points, m, fronts, rank, order, staircases);
+
+        // Every point of a front after the first is dominated by a point of the previous front.
+        for (size_t f = 1; f < fronts.size(); f += 97) {
+            const std::vector<size_t> &previous = fronts[f - 1];
+            bool dominated = false;
+            for (size_t index: previous) {
+                dominated = dominated || dominates(points[index], points[fronts[f][0]], m);
+            }
+            REQUIRE(dominated);
+        }
+    }
+}
+
+TEST_CASE("Non-dominated sort with three distinct objectives", "[pareto]") {
+    rng.seed(9);
+    std::uniform_real_distribution<double> dist(0, 1);
+    std::vector<objective_vector> points(1000);
+    for (objective_vector &point: points) {
+        point = {dist(rng), dist(rng), dist(rng)};
+    }
+    std::vector<std::vector<size_t>> fronts;
+    std::vector<unsigned int> rank;
+    std::vector<size_t> order;
+    std::vector<staircase> staircases;
+    non_dominated_sort(points, 3, fronts, rank, order, staircases);
+    REQUIRE(rank == brute_force_rank(points, 3));
+}
+
+TEST_CASE("Crowding distance", "[pareto]") {
+    std::vector<objective_vector> points = {{0, 4, 0}, {1, 3, 0}, {3, 1, 0}, {4, 0, 0}};
+    std::vector<size_t> front = {0, 1, 2, 3};
+    std::vector<double> distance(points.size());
+    std::vector<size_t> sorted;
+    crowding_distance(points, 2, front, distance, sorted);
+    REQUIRE(distance[0] == std::numeric_limits<double>::infinity());
+    REQUIRE(distance[3] == std::numeric_limits<double>::infinity());
+    REQUIRE_THAT(distance[1], Catch::Matchers::WithinAbs(1.5, 1e-12));
+    REQUIRE_THAT(distance[2], Catch::Matchers::WithinAbs(1.5, 1e-12));
+}
+
+TEST_CASE("Pareto front of Schaffer's problem", "[pareto]") {
+    // Both objectives are maximised at different points, so the Pareto set is [0, 2].
+    auto schaffer = [](double x) -> objective_vector {
+        return {-x * x, -(x - 2) * (x - 2), 0};
+    };
+    rng.seed(11);
+    MultiOptimiser opt(schaffer, 2, 100, {-5, 5}, 3, 0.9, 0.2, 100);
+    std::vector<pareto_point> front = opt.optimise();
+
+    REQUIRE(front.size() > 50);
+    for (size_t i = 0; i < front.size(); i++) {
+        REQUIRE(front[i].x >= -0.01);
+        REQUIRE(front[i].x <= 2.01);
+        for (size_t j = 0; j < front.size(); j++) {
+            REQUIRE_FALSE(dominates(front[i].objectives, front[j].objectives, 2));
+        }
+    }
+    // The front is spread over the whole Pareto set.
+    REQUIRE(front.front().x < 0.2);
+    REQUIRE(front.back().x > 1.8);
+}
+
+TEST_CASE("Odd and tiny populations", "[pareto]") {
+    auto schaffer = [](double x) -> objective_vector {
+        return {-x * x, -(x - 2) * (x - 2), 0};
+    };
+    rng.seed(13);
+    for (unsigned int size: {1u, 7u}) {
+        MultiOptimiser opt(schaffer, 2, size, {-5, 5}, 3, 0.9, 0.2, 20);
+        std::vector<pareto_point> front = opt.optimise();
+        REQUIRE(!front.empty());
+        REQUIRE(front.size() <= size);
+    }
+}
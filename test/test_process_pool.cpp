@@ -0,0 +1,83 @@
+//
+// Created by visan on 5/18/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include "../src/optimiser.h"
+#include "../src/process_pool.h"
+
+using namespace GeneticSimulation;
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+static std::vector<double> sample_points(size_t n) {
+    std::vector<double> points;
+    for (size_t i = 0; i < n; i++) {
+        points.push_back(-1 + 3.0 * (double) i / (double) n);
+    }
+    return points;
+}
+
+TEST_CASE("Workers evaluate batches", "[process_pool]") {
+    ProcessPool pool({TEST_WORKER}, 3, 64);
+    std::vector<double> points = sample_points(1000), values;
+
+    pool.evaluate(points, values);
+    REQUIRE(values.size() == points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        REQUIRE(values[i] == parabola(points[i]));
+    }
+
+    // The pool can be reused, and empty batches work.
+    pool.evaluate({}, values);
+    REQUIRE(values.empty());
+    REQUIRE(pool.evaluate(0.5) == parabola(0.5));
+    REQUIRE(pool.get_restarts() == 0);
+}
+
+TEST_CASE("Crashed workers are restarted", "[process_pool]") {
+    // Every worker crashes in the middle of its third batch, which is then sent to the restarted worker.
+    ProcessPool pool({TEST_WORKER, "--crash-after", "150"}, 2, 64);
+    std::vector<double> points = sample_points(1000), values;
+
+    pool.evaluate(points, values);
+    for (size_t i = 0; i < points.size(); i++) {
+        REQUIRE(values[i] == parabola(points[i]));
+    }
+    REQUIRE(pool.get_restarts() > 0);
+}
+
+TEST_CASE("Batches that always fail are reported", "[process_pool]") {
+    ProcessPool pool({TEST_WORKER, "--crash-after", "0"}, 1, 64, 2);
+    std::vector<double> values;
+    REQUIRE_THROWS_AS(pool.evaluate(sample_points(10), values), std::runtime_error);
+}
+
+TEST_CASE("The pool is reused after a batch fails", "[process_pool]") {
+    // The first batch always crashes its worker, while the other worker keeps answering its batches.
+    ProcessPool pool({TEST_WORKER, "--crash-above", "3"}, 2, 1, 2);
+    std::vector<double> points(40, 0.25), values;
+    points[0] = 5;
+    REQUIRE_THROWS_AS(pool.evaluate(points, values), std::runtime_error);
+
+    // No response to the failed call is read by the next one.
+    pool.evaluate({0, 0.5, 1}, values);
+    REQUIRE(values == std::vector<double>{parabola(0), parabola(0.5), parabola(1)});
+    REQUIRE(pool.evaluate(-1) == parabola(-1));
+}
+
+TEST_CASE("Optimiser with out-of-process evaluation", "[process_pool]") {
+    ProcessPool pool({TEST_WORKER}, 2, 16);
+    Optimiser local(parabola, 50, {-1, 2}, 6, 0.25, 0.01, 100);
+    Optimiser remote(parabola, 50, {-1, 2}, 6, 0.25, 0.01, 100);
+    remote.set_batch_evaluator([&pool](const std::vector<double> &points, std::vector<double> &values) {
+        pool.evaluate(points, values);
+    });
+
+    // The same seed gives the same run, whichever way the function is evaluated.
+    rng.seed(4);
+    double x = local.optimise();
+    rng.seed(4);
+    REQUIRE(remote.optimise() == x);
+}
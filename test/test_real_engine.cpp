@@ -0,0 +1,103 @@
+//
+// Created by visan on 5/27/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include<cmath>
+#include "../src/real_engine.h"
+
+using namespace GeneticSimulation;
+using Catch::Matchers::WithinAbs;
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+TEST_CASE("Simulated binary cross-over", "[real]") {
+    rng.seed(31);
+    SimulatedBinaryCrossover sbx{2};
+    for (int i = 0; i < 1000; i++) {
+        double a = 0.2, b = 0.6;
+        sbx.cross<NoTrace>(a, b, {-100, 100}, std::cout);
+        // The children are symmetric around the mean of the parents.
+        REQUIRE_THAT(a + b, WithinAbs(0.8, 1e-12));
+    }
+
+    double a = -0.9, b = 0.9;
+    for (int i = 0; i < 1000; i++) {
+        sbx.cross<NoTrace>(a, b, {-1, 1}, std::cout);
+        REQUIRE(a >= -1);
+        REQUIRE(b <= 1);
+    }
+}
+
+TEST_CASE("Blend cross-over", "[real]") {
+    rng.seed(32);
+    BlendCrossover blx{0.5};
+    for (int i = 0; i < 1000; i++) {
+        double a = 1, b = 2;
+        blx.cross<NoTrace>(a, b, {-10, 10}, std::cout);
+        // The interval [1, 2] extended by half its length on both sides.
+        REQUIRE(a >= 0.5);
+        REQUIRE(a <= 2.5);
+        REQUIRE(b >= 0.5);
+        REQUIRE(b <= 2.5);
+    }
+}
+
+TEST_CASE("Real mutations", "[real]") {
+    rng.seed(33);
+    GaussianMutation gaussian{0.1};
+    PolynomialMutation polynomial{20};
+    double moved = 0;
+    for (int i = 0; i < 1000; i++) {
+        double x = 0.9, y = 0.9;
+        gaussian.mutate<NoTrace>(x, {0, 1}, std::cout);
+        polynomial.mutate<NoTrace>(y, {0, 1}, std::cout);
+        REQUIRE(x >= 0);
+        REQUIRE(x <= 1);
+        REQUIRE(y >= 0);
+        REQUIRE(y <= 1);
+        moved += std::abs(y - 0.9);
+    }
+    // Polynomial mutation makes small steps: the mean of |delta| is 1 / (eta + 2) of the domain, less with clamping.
+    REQUIRE(moved / 1000 < 1.0 / 22);
+    REQUIRE(moved / 1000 > 0.02);
+}
+
+TEST_CASE("Real-coded engine", "[real]") {
+    rng.seed(34);
+    RealEngine<> engine(parabola, 30, {-1, 2}, 0.6, 0.2);
+    engine.set_telemetry(true);
+    double x = engine.run(300);
+
+    // The precision is not limited by a number of bits.
+    REQUIRE_THAT(x, WithinAbs(0.5, 1e-4));
+    REQUIRE(engine.get_population().size() == 30);
+    REQUIRE(engine.get_evaluations() == 301 * 30);
+    REQUIRE(engine.get_telemetry().size() == 300);
+    REQUIRE(engine.get_telemetry().back().diversity < engine.get_telemetry().front().diversity);
+}
+
+TEST_CASE("Real-coded engine with other policies", "[real]") {
+    rng.seed(35);
+    RealEngine<TournamentSelection, BlendCrossover, GaussianMutation> engine(parabola, 30, {-1, 2}, 0.6, 0.2,
+                                                                               BlendCrossover{0.3},
+                                                                               GaussianMutation{0.01});
+    REQUIRE_THAT(engine.run(300), WithinAbs(0.5, 1e-3));
+}
+
+TEST_CASE("Integer genes", "[real]") {
+    rng.seed(36);
+    // The maximum of -(x - 3.4)^2 among the integers is at 3.
+    auto objective = [](double x) {
+        return 100 - (x - 3.4) * (x - 3.4);
+    };
+    RealEngine<RouletteSelection, SimulatedBinaryCrossover, PolynomialMutation, NoTrace, decltype(objective)>
+            engine(objective, 20, {-10, 10}, 0.6, 0.2);
+    engine.set_resolution(1);
+    REQUIRE(engine.run(100) == 3);
+    for (double x: engine.get_population()) {
+        REQUIRE(x == std::round(x));
+    }
+}
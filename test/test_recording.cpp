@@ -0,0 +1,91 @@
+//
+// Created by visan on 5/24/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<sstream>
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+static run_record record(std::mt19937::result_type seed, double mutation_probability = 0.01) {
+    Optimiser opt(parabola, 20, {-1, 2}, 6, 0.25, mutation_probability, 50);
+    opt.set_recording(true, seed);
+    opt.optimise();
+    return opt.get_recording();
+}
+
+TEST_CASE("Recorded runs can be replayed", "[recording]") {
+    run_record first = record(3);
+    // The global generator is in another state, but the run seeds it.
+    rng.seed(1234);
+    run_record second = record(3);
+
+    REQUIRE(first.epochs.size() == 50);
+    REQUIRE(first.epochs == second.epochs);
+    REQUIRE(record(4).epochs != first.epochs);
+}
+
+TEST_CASE("Runs round-trip through the text format", "[recording]") {
+    std::vector<run_record> runs = {record(1), record(2)};
+    std::stringstream stream;
+    save_runs(stream, runs);
+    std::vector<run_record> loaded = load_runs(stream);
+
+    REQUIRE(loaded.size() == 2);
+    for (size_t r = 0; r < runs.size(); r++) {
+        REQUIRE(loaded[r].seed == runs[r].seed);
+        REQUIRE(loaded[r].epochs == runs[r].epochs);
+    }
+
+    std::stringstream malformed("run 1\n0 ff 10\n");
+    REQUIRE_THROWS_AS(load_runs(malformed), std::runtime_error);
+}
+
+TEST_CASE("Comparing recordings", "[recording]") {
+    std::vector<run_record> baseline, same, changed, worse;
+    for (std::mt19937::result_type seed = 1; seed <= 12; seed++) {
+        baseline.push_back(record(seed));
+        same.push_back(record(seed));
+        // A different mutation rate changes the random sequence, but not the quality of the result.
+        changed.push_back(record(seed, 0.02));
+
+        // A broken build, which only reaches half of the fitness.
+        run_record broken = record(seed);
+        for (epoch_digest &digest: broken.epochs) {
+            digest.max_fitness /= 2;
+        }
+        worse.push_back(broken);
+    }
+
+    comparison identical = compare_runs(baseline, same);
+    REQUIRE(identical.verdict == comparison::Verdict::identical);
+    REQUIRE(identical.divergent_runs == 0);
+
+    comparison equivalent = compare_runs(baseline, changed);
+    REQUIRE(equivalent.verdict == comparison::Verdict::equivalent);
+    REQUIRE(equivalent.divergent_runs > 0);
+
+    comparison different = compare_runs(baseline, worse);
+    REQUIRE(different.verdict == comparison::Verdict::different);
+    REQUIRE(different.divergent_runs == 12);
+    REQUIRE(different.first_divergent_seed == 1);
+    REQUIRE(different.first_divergent_epoch == 0);
+
+    // The runs are matched by seed, whatever their order.
+    std::vector<run_record> reversed(same.rbegin(), same.rend());
+    REQUIRE(compare_runs(baseline, reversed).verdict == comparison::Verdict::identical);
+    std::vector<run_record> reversed_worse(worse.rbegin(), worse.rend());
+    REQUIRE(compare_runs(baseline, reversed_worse).first_divergent_seed == 1);
+
+    std::vector<run_record> shifted = same;
+    shifted[0].seed = 100;
+    REQUIRE_THROWS_AS(compare_runs(baseline, shifted), std::runtime_error);
+    std::vector<run_record> repeated = same;
+    repeated[0].seed = 2;
+    REQUIRE_THROWS_AS(compare_runs(baseline, repeated), std::runtime_error);
+    REQUIRE_THROWS_AS(compare_runs(repeated, baseline), std::runtime_error);
+}
@@ -0,0 +1,136 @@
+//
+// Created by visan on 5/22/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<catch2/matchers/catch_matchers_floating_point.hpp>
+#include<algorithm>
+#include "../src/optimiser.h"
+
+using namespace GeneticSimulation;
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+// Returns the fitness of every organism of the population, sorted in decreasing order.
+static std::vector<double> sorted_fitness(const Optimiser &opt, const std::vector<Organism> &population) {
+    std::vector<double> result;
+    for (const Organism &o: population) {
+        result.push_back(opt.fitness(o));
+    }
+    std::sort(result.begin(), result.end(), std::greater<>());
+    return result;
+}
+
+TEST_CASE("Top k indices", "[replacement]") {
+    std::vector<double> values = {3, 9, 1, 7, 5, 8, 2};
+    std::vector<size_t> indices = {0, 1, 2, 3, 4, 5, 6};
+    top_k(indices, 3, [&values](size_t a, size_t b) {
+        return values[a] > values[b];
+    });
+    std::sort(indices.begin(), indices.begin() + 3);
+    REQUIRE(indices[0] == 1);
+    REQUIRE(indices[1] == 3);
+    REQUIRE(indices[2] == 5);
+}
+
+TEST_CASE("Offspring counts", "[replacement]") {
+    REQUIRE(Replacement::generational().elites(10) == 1);
+    REQUIRE(Replacement::generational().offspring(10) == 9);
+    REQUIRE(Replacement::generational(20).elites(10) == 10);
+    REQUIRE(Replacement::generational(20).offspring(10) == 0);
+    REQUIRE(Replacement::plus(4).offspring(10) == 4);
+    REQUIRE(Replacement::plus(4).elites(10) == 0);
+    REQUIRE(Replacement::comma(4).offspring(10) == 10);
+    REQUIRE(Replacement::comma(30).offspring(10) == 30);
+    REQUIRE(Replacement::age(30).offspring(10) == 9);
+}
+
+TEST_CASE("Generational replacement keeps the elites", "[replacement]") {
+    rng.seed(11);
+    Optimiser opt(parabola, 40, {-1, 2}, 6, 0.9, 0.5, 100);
+    opt.set_replacement(Replacement::generational(5));
+    std::vector<Organism> population = opt.initial_population();
+
+    for (int e = 0; e < 20; e++) {
+        std::vector<double> before = sorted_fitness(opt, population);
+        opt.evolve(population);
+        std::vector<double> after = sorted_fitness(opt, population);
+        REQUIRE(population.size() == 40);
+        // The five best scores of the population can only improve.
+        for (size_t i = 0; i < 5; i++) {
+            REQUIRE(after[i] >= before[i]);
+        }
+    }
+}
+
+TEST_CASE("Plus replacement", "[replacement]") {
+    rng.seed(12);
+    Optimiser opt(parabola, 20, {-1, 2}, 6, 0.5, 0.5, 100);
+    opt.set_replacement(Replacement::plus(10));
+    std::vector<Organism> population = opt.initial_population();
+    opt.evolve(population);
+
+    for (int e = 0; e < 50; e++) {
+        std::vector<double> before = sorted_fitness(opt, population);
+        unsigned long long evaluations = opt.get_evaluations();
+        opt.evolve(population);
+        // Only the offspring are evaluated, the survivors keep their scores.
+        REQUIRE(opt.get_evaluations() - evaluations == 10);
+
+        std::vector<double> after = sorted_fitness(opt, population);
+        REQUIRE(population.size() == 20);
+        // No organism is replaced by a worse one.
+        for (size_t i = 0; i < after.size(); i++) {
+            REQUIRE(after[i] >= before[i]);
+        }
+    }
+    REQUIRE_THAT(sorted_fitness(opt, population)[0], Catch::Matchers::WithinAbs(2.25, 1e-4));
+}
+
+TEST_CASE("Comma replacement", "[replacement]") {
+    rng.seed(13);
+    Optimiser opt(parabola, 20, {-1, 2}, 6, 0.5, 0.5, 100);
+    opt.set_replacement(Replacement::comma(60));
+    std::vector<Organism> population = opt.initial_population();
+    opt.evolve(population);
+
+    for (int e = 0; e < 50; e++) {
+        unsigned long long evaluations = opt.get_evaluations();
+        opt.evolve(population);
+        REQUIRE(opt.get_evaluations() - evaluations == 60);
+        REQUIRE(population.size() == 20);
+    }
+    REQUIRE_THAT(sorted_fitness(opt, population)[0], Catch::Matchers::WithinAbs(2.25, 1e-3));
+}
+
+TEST_CASE("Age-based replacement", "[replacement]") {
+    rng.seed(14);
+    Optimiser opt(parabola, 20, {-1, 2}, 6, 0.5, 0.5, 100);
+    opt.set_replacement(Replacement::age(5));
+    std::vector<Organism> population = opt.initial_population();
+    opt.evolve(population);
+
+    for (int e = 0; e < 50; e++) {
+        std::vector<Organism> before = population;
+        double best = sorted_fitness(opt, population)[0];
+        unsigned long long evaluations = opt.get_evaluations();
+        opt.evolve(population);
+        REQUIRE(opt.get_evaluations() - evaluations == 5);
+
+        // At most 5 organisms are replaced, and the fittest one survives.
+        size_t replaced = 0;
+        for (size_t i = 0; i < population.size(); i++) {
+            replaced += population[i].get_chromosome() != before[i].get_chromosome();
+        }
+        REQUIRE(replaced <= 5);
+        REQUIRE(sorted_fitness(opt, population)[0] >= best);
+    }
+}
+
+TEST_CASE("Optimising with a plus replacement", "[replacement]") {
+    rng.seed(15);
+    Optimiser opt(parabola, 20, {-1, 2}, 6, 0.5, 0.2, 200);
+    opt.set_replacement(Replacement::plus(20));
+    REQUIRE_THAT(opt.optimise(), Catch::Matchers::WithinAbs(0.5, 1e-2));
+}
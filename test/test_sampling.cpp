@@ -0,0 +1,95 @@
+//
+// Created by visan on 5/21/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<vector>
+#include "../src/sampling.h"
+
+using namespace GeneticSimulation;
+
+// The sequences below only depend on the output of std::mt19937 with the default seed,
+// which is specified by the standard, so they are the same with every compiler.
+
+TEST_CASE("Uniform doubles", "[sampling]") {
+    std::mt19937 generator;
+    REQUIRE(uniform(generator) == 0.8147236863931789);
+
+    std::mt19937 a(42), b(42);
+    std::vector<double> values(1000);
+    fill_uniform(a, values.data(), values.size());
+    for (double value: values) {
+        REQUIRE(value == uniform(b));
+        REQUIRE(value >= 0);
+        REQUIRE(value < 1);
+    }
+    REQUIRE(a() == b());
+}
+
+TEST_CASE("Bounded integers", "[sampling]") {
+    std::mt19937 generator;
+    std::vector<uint32_t> expected = {4, 0, 5, 5, 0, 5};
+    for (uint32_t value: expected) {
+        REQUIRE(bounded(generator, 6) == value);
+    }
+
+    generator.seed();
+    expected = {814723, 135477, 905791, 835008};
+    for (uint32_t value: expected) {
+        REQUIRE(bounded(generator, 1000000) == value);
+    }
+
+    std::mt19937 a(7), b(7);
+    std::vector<uint32_t> values(1000);
+    fill_bounded(a, 10, values.data(), values.size());
+    for (uint32_t value: values) {
+        REQUIRE(value == bounded(b, 10));
+    }
+}
+
+TEST_CASE("Bounded integers are unbiased", "[sampling]") {
+    // With a range of 3 * 2^30, a biased method would draw the first 2^30 values twice as often as the others.
+    std::mt19937 generator(3);
+    const uint32_t range = 3u << 30;
+    unsigned int low = 0;
+    const unsigned int samples = 300000;
+    for (unsigned int i = 0; i < samples; i++) {
+        uint32_t value = bounded(generator, range);
+        REQUIRE(value < range);
+        low += value < (1u << 30);
+    }
+    // A third of the samples is expected in the first 2^30 values, and a half with the bias.
+    REQUIRE(low > samples * 0.32);
+    REQUIRE(low < samples * 0.35);
+
+    REQUIRE(bounded(generator, 1) == 0);
+}
+
+TEST_CASE("Geometric gaps", "[sampling]") {
+    std::mt19937 generator(5);
+    REQUIRE(geometric(generator, 1) == 0);
+
+    // The mean number of failures is (1 - p) / p.
+    double sum = 0;
+    const unsigned int samples = 100000;
+    for (unsigned int i = 0; i < samples; i++) {
+        sum += (double) geometric(generator, 0.1);
+    }
+    REQUIRE(sum / samples > 8.8);
+    REQUIRE(sum / samples < 9.2);
+}
+
+TEST_CASE("Normal doubles", "[sampling]") {
+    std::mt19937 generator(6);
+    double sum = 0, squares = 0;
+    const unsigned int samples = 100000;
+    for (unsigned int i = 0; i < samples; i++) {
+        double value = normal(generator);
+        sum += value;
+        squares += value * value;
+    }
+    double mean = sum / samples;
+    REQUIRE(mean > -0.02);
+    REQUIRE(mean < 0.02);
+    REQUIRE(squares / samples - mean * mean > 0.98);
+    REQUIRE(squares / samples - mean * mean < 1.02);
+}
@@ -0,0 +1,158 @@
+//
+// Created by visan on 5/20/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<bitset>
+#include "../src/sliced.h"
+
+using namespace GeneticSimulation;
+
+TEST_CASE("Transpose kernel", "[sliced]") {
+    rng.seed(1);
+    uint64_t rows[64], transposed[64];
+    for (uint64_t &row: rows) {
+        row = ((uint64_t) rng() << 32) | rng();
+    }
+    std::copy(rows, rows + 64, transposed);
+    transpose64(transposed);
+    for (unsigned int i = 0; i < 64; i++) {
+        for (unsigned int j = 0; j < 64; j++) {
+            REQUIRE(((rows[i] >> j) & 1) == ((transposed[j] >> i) & 1));
+        }
+    }
+}
+
+TEST_CASE("Sliced population layout", "[sliced]") {
+    rng.seed(2);
+    // The last block is only partially used.
+    SlicedPopulation population(12, 150);
+    std::vector<bitvector> chromosomes;
+    for (size_t i = 0; i < 150; i++) {
+        chromosomes.push_back(random_bitvector(12));
+        population.set(i, chromosomes[i]);
+    }
+
+    for (size_t i = 0; i < 150; i++) {
+        REQUIRE(population.get(i) == chromosomes[i]);
+    }
+
+    bitvector decoded[64];
+    for (size_t block = 0; block < 3; block++) {
+        population.decode(block, decoded);
+        for (size_t lane = 0; lane < 64; lane++) {
+            size_t index = block * 64 + lane;
+            REQUIRE(decoded[lane] == (index < 150 ? chromosomes[index] : 0));
+        }
+    }
+
+    std::vector<size_t> counts;
+    population.bit_frequencies(counts);
+    REQUIRE(counts.size() == 12);
+    for (unsigned int gene = 0; gene < 12; gene++) {
+        size_t expected = 0;
+        for (bitvector chromosome: chromosomes) {
+            expected += (chromosome >> gene) & 1;
+        }
+        REQUIRE(counts[gene] == expected);
+    }
+}
+
+TEST_CASE("Sliced mutation", "[sliced]") {
+    rng.seed(3);
+    SlicedPopulation population = SlicedPopulation::random_population(10, 100);
+    std::vector<bitvector> before;
+    for (size_t i = 0; i < 100; i++) {
+        before.push_back(population.get(i));
+    }
+
+    SECTION("Probability 0") {
+        population.mutate(0);
+        for (size_t i = 0; i < 100; i++) {
+            REQUIRE(population.get(i) == before[i]);
+        }
+    }
+
+    SECTION("Probability 1") {
+        population.mutate(1);
+        for (size_t i = 0; i < 100; i++) {
+            REQUIRE(population.get(i) == (~before[i] & 0b1111111111));
+        }
+        std::vector<size_t> counts;
+        population.bit_frequencies(counts);
+        for (size_t count: counts) {
+            REQUIRE(count <= 100);
+        }
+    }
+
+    SECTION("Small probability") {
+        SlicedPopulation large = SlicedPopulation::random_population(16, 64000);
+        std::vector<size_t> counts_before;
+        large.bit_frequencies(counts_before);
+        std::vector<bitvector> chromosomes;
+        for (size_t i = 0; i < 64000; i++) {
+            chromosomes.push_back(large.get(i));
+        }
+
+        large.mutate(0.01);
+        size_t flipped = 0;
+        for (size_t i = 0; i < 64000; i++) {
+            flipped += std::bitset<64>(chromosomes[i] ^ large.get(i)).count();
+        }
+        // 10240 flips are expected.
+        REQUIRE(flipped > 9500);
+        REQUIRE(flipped < 11000);
+    }
+}
+
+TEST_CASE("Sliced uniform cross-over", "[sliced]") {
+    rng.seed(4);
+    SlicedPopulation population = SlicedPopulation::random_population(20, 1000);
+    std::vector<size_t> before, after;
+    population.bit_frequencies(before);
+
+    std::vector<bitvector> chromosomes;
+    for (size_t i = 0; i < 1000; i++) {
+        chromosomes.push_back(population.get(i));
+    }
+
+    population.uniform_crossover(1);
+    population.bit_frequencies(after);
+
+    // Cross-over only swaps genes between organisms, so the number of set genes does not change.
+    REQUIRE(before == after);
+    size_t changed = 0;
+    for (size_t i = 0; i < 1000; i++) {
+        changed += population.get(i) != chromosomes[i];
+    }
+    REQUIRE(changed > 900);
+}
+
+TEST_CASE("Sliced cross-over probability", "[sliced]") {
+    rng.seed(5);
+    SlicedPopulation population = SlicedPopulation::random_population(24, 64000);
+    std::vector<bitvector> chromosomes;
+    for (size_t i = 0; i < 64000; i++) {
+        chromosomes.push_back(population.get(i));
+    }
+
+    population.uniform_crossover(0.3);
+    size_t changed = 0;
+    for (size_t i = 0; i < 64000; i += 128) {
+        // Only the organisms of the even blocks decide if they are crossed.
+        for (size_t lane = 0; lane < 64; lane++) {
+            changed += population.get(i + lane) != chromosomes[i + lane];
+        }
+    }
+    // 0.3 * 32000 = 9600 organisms are expected to change.
+    REQUIRE(changed > 9000);
+    REQUIRE(changed < 10200);
+
+    population.uniform_crossover(0);
+    for (size_t i = 0; i < 64000; i++) {
+        chromosomes[i] = population.get(i);
+    }
+    population.uniform_crossover(0);
+    for (size_t i = 0; i < 64000; i++) {
+        REQUIRE(population.get(i) == chromosomes[i]);
+    }
+}
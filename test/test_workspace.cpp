@@ -0,0 +1,126 @@
+//
+// Created by visan on 5/14/23.
+//
+#include<catch2/catch_test_macros.hpp>
+#include<cstdlib>
+#include<new>
+#include "../src/optimiser.h"
+#include "../src/pareto.h"
+
+using namespace GeneticSimulation;
+
+// Counts the heap allocations made while counting is enabled. The replacement is global, so these tests are built
+// into their own executable (TestAllocations).
+static bool counting = false;
+static size_t allocations = 0;
+
+void *operator new(size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+static double parabola(double x) {
+    return -x * x + x + 2;
+}
+
+TEST_CASE("No allocations in the steady state", "[workspace]") {
+    Optimiser opt(parabola, 50, {-1, 2}, 6, 0.25, 0.01, 100);
+    std::vector<Organism> population = opt.initial_population();
+
+    // The first epoch warms up the workspace.
+    opt.evolve(population);
+
+    allocations = 0;
+    counting = true;
+    for (int e = 0; e < 100; e++) {
+        opt.evolve(population);
+    }
+    counting = false;
+
+    REQUIRE(allocations == 0);
+    REQUIRE(population.size() == 50);
+}
+
+TEST_CASE("No allocations in the steady state with other replacements", "[workspace]") {
+    for (Replacement replacement: {Replacement::generational(5), Replacement::plus(20), Replacement::comma(80),
+                                   Replacement::age(10)}) {
+        Optimiser opt(parabola, 50, {-1, 2}, 6, 0.25, 0.01, 100);
+        opt.set_replacement(replacement);
+        std::vector<Organism> population = opt.initial_population();
+        opt.evolve(population);
+
+        allocations = 0;
+        counting = true;
+        for (int e = 0; e < 100; e++) {
+            opt.evolve(population);
+        }
+        counting = false;
+
+        REQUIRE(allocations == 0);
+        REQUIRE(population.size() == 50);
+    }
+}
+
+TEST_CASE("No allocations in the steady state with niching", "[workspace]") {
+    for (Niching niching: {Niching::sharing(0.1), Niching::sharing(0.1, 2), Niching::clearing(0.1),
+                           Niching::crowding(0.1)}) {
+        Optimiser opt(parabola, 50, {-1, 2}, 6, 0.25, 0.01, 100);
+        opt.set_niching(niching);
+        std::vector<Organism> population = opt.initial_population();
+        opt.evolve(population);
+
+        allocations = 0;
+        counting = true;
+        for (int e = 0; e < 100; e++) {
+            opt.evolve(population);
+        }
+        counting = false;
+
+        REQUIRE(allocations == 0);
+        REQUIRE(population.size() == 50);
+    }
+}
+
+TEST_CASE("No allocations in the sort of two objectives", "[workspace]") {
+    std::vector<objective_vector> points;
+    for (int i = 0; i < 200; i++) {
+        points.push_back({uniform(rng), uniform(rng), 0});
+    }
+    std::vector<std::vector<size_t>> fronts;
+    std::vector<unsigned int> rank;
+    std::vector<size_t> order, sorted;
+    std::vector<staircase> staircases;
+    std::vector<double> distance(points.size());
+
+    // The first sort warms up the buffers.
+    non_dominated_sort(points, 2, fronts, rank, order, staircases);
+    for (const std::vector<size_t> &front: fronts) {
+        crowding_distance(points, 2, front, distance, sorted);
+    }
+
+    allocations = 0;
+    counting = true;
+    for (int i = 0; i < 10; i++) {
+        non_dominated_sort(points, 2, fronts, rank, order, staircases);
+        for (const std::vector<size_t> &front: fronts) {
+            crowding_distance(points, 2, front, distance, sorted);
+        }
+    }
+    counting = false;
+
+    REQUIRE(allocations == 0);
+}
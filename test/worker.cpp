@@ -0,0 +1,31 @@
+//
+// Created by visan on 5/18/23.
+//
+// A stand-in for an external objective. It evaluates -x^2 + x + 2 for the process pool.
+// With "--crash-after n", it crashes when it is asked to evaluate more than n points.
+// With "--crash-above x", it crashes when it is asked to evaluate a point greater than x.
+//
+#include<cstdlib>
+#include<cstring>
+#include<limits>
+#include<unistd.h>
+#include "../src/process_pool.h"
+
+int main(int argc, char **argv) {
+    long crash_after = -1;
+    double crash_above = std::numeric_limits<double>::infinity();
+    if (argc == 3 && strcmp(argv[1], "--crash-after") == 0) {
+        crash_after = atol(argv[2]);
+    }
+    if (argc == 3 && strcmp(argv[1], "--crash-above") == 0) {
+        crash_above = atof(argv[2]);
+    }
+
+    long evaluated = 0;
+    return GeneticSimulation::serve(STDIN_FILENO, STDOUT_FILENO, [&](double x) {
+        if ((crash_after >= 0 && evaluated++ >= crash_after) || x > crash_above) {
+            std::_Exit(1);
+        }
+        return -x * x + x + 2;
+    });
+}